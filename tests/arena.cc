@@ -0,0 +1,116 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <list>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "useful/arena.hpp"
+#include "useful/string.hpp"
+#include "useful/combos.hpp"
+#include "useful/sort.hpp"
+
+using namespace useful;
+
+// Count calls to the global heap
+static std::atomic<unsigned long> heap_calls{0};
+
+void *operator new(std::size_t n) {
+  heap_calls.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// One "request": tokenize, build combinations and sort, all from the
+// arena. Returns a checksum of the results.
+static long request(monotonic_arena &arena, const std::string &line, const combinations<int> &c,
+                    std::vector<int> &nums) {
+  arena_allocator<char> alloc(arena);
+  long check = 0;
+  for (const auto &w : tokenize(line, " ,", alloc))
+    check += w.size();
+  for (const auto &combo : c.combos(3, alloc))
+    check += combo.front() * combo.back();
+  merge_sort(nums.begin(), nums.end(), std::less<int>(), alloc);
+  return check + nums.front();
+}
+
+int main(void) {
+  monotonic_arena arena;
+  int *a = static_cast<int *>(arena.allocate(sizeof(int) * 10, alignof(int)));
+  double *d = static_cast<double *>(arena.allocate(sizeof(double), alignof(double)));
+  std::cout << "Allocated " << arena.bytes_used() << " bytes from a " << arena.capacity()
+            << " byte arena; double aligned: "
+            << (reinterpret_cast<std::uintptr_t>(d) % alignof(double) == 0 ? "yes" : "no") << '\n';
+  a[9] = 1;
+  *d = 2;
+  arena.reset();
+  std::cout << "After reset: " << arena.bytes_used() << " bytes used\n";
+
+  // Outgrow the first block; the next reset merges them into one
+  for (int i = 0; i < 100; i += 1)
+    arena.allocate(4096);
+  std::cout << "Capacity after 400K of allocations: " << arena.capacity() << '\n';
+  arena.reset();
+  std::cout << "Capacity after reset: " << arena.capacity() << '\n';
+
+  std::string line = "the quick brown fox, jumps over the lazy dog";
+  std::vector<int> nums(1000);
+  std::mt19937 rng(3);
+  for (auto &n : nums)
+    n = rng() % 1000;
+  auto sorted = nums;
+  std::stable_sort(sorted.begin(), sorted.end());
+
+  const std::vector<int> items{1, 2, 3, 4, 5, 6};
+  combinations<int> c(items);
+  long check = 0;
+  unsigned long calls = 0;
+  for (int i = 0; i < 5; i += 1) {
+    auto work = nums;
+    unsigned long before = heap_calls;
+    check = request(arena, line, c, work);
+    calls = heap_calls - before;
+    arena.reset();
+    if (work != sorted)
+      std::cout << "merge_sort got it wrong!\n";
+  }
+  // The one left is the combination iterator's own index state
+  std::cout << "\nChecksum " << check << ", heap calls in the last request: " << calls << '\n';
+
+  // The strings and vector come from the arena, though std::regex still
+  // uses the heap for its own matching state.
+  arena_allocator<char> alloc(arena);
+  auto words = splitv(line, "[ ,]+", alloc);
+  std::cout << "splitv into " << words.size() << " words, last one \"" << words.back()
+            << "\"; arena has " << arena.bytes_used() << " bytes used\n";
+
+  // Node-based containers reuse freed nodes from a pool_arena
+  pool_arena pool;
+  {
+    std::list<int, arena_allocator<int, pool_arena>> l{arena_allocator<int, pool_arena>(pool)};
+    for (int round = 0; round < 10; round += 1) {
+      for (int i = 0; i < 1000; i += 1)
+        l.push_back(i);
+      l.clear();
+    }
+    std::cout << "\nList of 1000 nodes filled 10 times from a " << pool.capacity() << " byte pool\n";
+  }
+
+  // Merge sort on a list through the thread's arena
+  std::list<std::string> fruit{"pear", "apple", "fig", "banana", "cherry", "date"};
+  merge_sort(fruit.begin(), fruit.end(), std::less<std::string>(), arena_allocator<char>(thread_arena()));
+  thread_arena().reset();
+  std::cout << "Sorted:";
+  for (const auto &w : fruit)
+    std::cout << ' ' << w;
+  std::cout << '\n';
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+
+#include "useful/combos.hpp"
+
+using namespace useful;
+
+int main(void) {
+	std::vector<int> v{1, 2, 3, 4, 5};
+	combinations<int> c(v);
+
+	std::cout << "C(67, 33) = " << ncr(67, 33) << "\nln C(1000, 500) = " << log_ncr(1000, 500) << '\n';
+	try {
+		ncr_checked(68, 34);
+	} catch (std::overflow_error &e) {
+		std::cout << "C(68, 34) doesn't fit in 64 bits.\n";
+	}
+	try {
+		std::cout << "C(33, 16) = " << ncr_checked<int>(33, 16) << " as an int\n";
+		ncr_checked<int>(34, 17);
+	} catch (std::overflow_error &e) {
+		std::cout << "C(34, 17) doesn't fit in an int.\n";
+	}
+
+	std::cout << "\nC(5, 3) = " << c.count(3) << "\nAll at once:\n";
+	for (const auto &combo : c.combos(3)) {
+		for (auto i : combo)
+			std::cout << i << ' ';
+		std::cout << '\n';
+	}
+
+	std::cout << "\nIn one flat buffer:\n";
+	for (auto combo : c.combos_flat(3)) {
+		for (auto i : combo)
+			std::cout << i << ' ';
+		std::cout << '\n';
+	}
+
+	std::cout << "\nLazily:\n";
+	std::uint64_t n = 0;
+	for (auto combo : c.lazy_combos(3)) {
+		for (auto i : combo)
+			std::cout << i << ' ';
+		std::cout << '\n';
+		n += 1;
+	}
+	std::cout << n << " combinations.\n";
+
+	combination_range<int> range(v, 3);
+	auto from5 = range.at(5);
+	std::cout << "\nStarting from rank 5: ";
+	for (auto i : *from5)
+		std::cout << i << ' ';
+	std::cout << "(rank " << range.rank(*from5) << ")\n";
+
+	std::vector<int> big(40);
+	std::iota(big.begin(), big.end(), 0);
+	std::atomic<long> seen{0}, total{0};
+	parallel_for_each_combination(big, 5, [&](auto combo) {
+			seen += 1;
+			total += combo[4];
+		}, 4);
+	std::cout << "C(40, 5) on 4 threads: " << seen << " combinations, sum of last elements "
+		<< total << '\n';
+
+	std::vector<char> letters{'a', 'b', 'c', 'd'};
+	permutations<char> perms(letters, 2);
+	std::cout << "\nPermutations of 2 of abcd:";
+	for (auto p : perms)
+		std::cout << ' ' << p[0] << p[1];
+	auto p7 = perms.at(7);
+	std::cout << "\nRank 7 is " << (*p7)[0] << (*p7)[1] << " (rank " << perms.rank(*p7) << ")\n";
+
+	std::vector<int> ten(10);
+	std::iota(ten.begin(), ten.end(), 0);
+	std::atomic<long> pseen{0};
+	parallel_for_each_permutation(ten, 5, [&](auto) { pseen += 1; }, 4);
+	std::cout << "P(10, 5) on 4 threads: " << pseen << " permutations\n";
+
+	return n == c.count(3) && seen == 658008 && total == 21823932 && pseen == 30240 ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+// Compares combos(), which returns a vector of vectors, with
+// combos_flat(), which returns one contiguous buffer, and with
+// iterating lazily. Prints CSV:
+// method,n,r,combinations,build_seconds,iterate_seconds,allocations,bytes,checksum
+//
+// Usage: combos_bench [n, default 24] [r, default 6]
+
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "useful/combos.hpp"
+
+using namespace useful;
+using clock_type = std::chrono::steady_clock;
+
+// Count heap allocations and bytes allocated.
+static std::atomic<unsigned long> allocations{0}, allocated{0};
+
+void *operator new(std::size_t n) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated.fetch_add(n, std::memory_order_relaxed);
+  if (void *p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+template<class Build, class Iterate>
+void measure(const char *method, int n, int r, Build build, Iterate iterate) {
+  double best_build = 1e100, best_iter = 1e100;
+  unsigned long allocs = 0, bytes = 0;
+  std::size_t count = 0;
+  long sum = 0;
+  for (int runs = 0; runs < 5; runs += 1) {
+    unsigned long a = allocations, b = allocated;
+    auto start = clock_type::now();
+    auto res = build();
+    std::chrono::duration<double> secs = clock_type::now() - start;
+    allocs = allocations - a;
+    bytes = allocated - b;
+    best_build = std::min(best_build, secs.count());
+    start = clock_type::now();
+    count = 0;
+    sum += iterate(res, count);
+    secs = clock_type::now() - start;
+    best_iter = std::min(best_iter, secs.count());
+  }
+  std::cout << method << ',' << n << ',' << r << ',' << count << ',' << best_build << ','
+            << best_iter << ',' << allocs << ',' << bytes << ',' << sum << '\n';
+}
+
+int main(int argc, char **argv) {
+  int n = argc > 1 ? std::atoi(argv[1]) : 24;
+  int r = argc > 2 ? std::atoi(argv[2]) : 6;
+
+  std::vector<int> items(n);
+  std::iota(items.begin(), items.end(), 0);
+  combinations<int> c(items);
+
+  std::cout << "method,n,r,combinations,build_seconds,iterate_seconds,allocations,bytes,checksum\n";
+  measure("combos", n, r, [&] { return c.combos(r); },
+          [](const auto &res, std::size_t &count) {
+            long sum = 0;
+            for (const auto &combo : res) {
+              for (auto i : combo)
+                sum += i;
+              count += 1;
+            }
+            return sum;
+          });
+  measure("combos_flat", n, r, [&] { return c.combos_flat(r); },
+          [](const auto &res, std::size_t &count) {
+            // The rows are contiguous, so this is one flat loop.
+            count = res.size();
+            return std::accumulate(res.elements().begin(), res.elements().end(), 0L);
+          });
+  measure("lazy_combos", n, r, [&] { return c.lazy_combos(r); },
+          [](const auto &res, std::size_t &count) {
+            long sum = 0;
+            for (auto combo : res) {
+              for (auto i : combo)
+                sum += i;
+              count += 1;
+            }
+            return sum;
+          });
+
+  return 0;
+}
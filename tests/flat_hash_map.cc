@@ -0,0 +1,54 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <random>
+
+#include "useful/flat_hash_map.hpp"
+
+using namespace useful;
+
+int main(void) {
+  flat_string_map<int> ages{{"alice", 30}, {"bob", 25}};
+  ages["carol"] = 41;
+  std::string_view bob = "bob";
+  ages[bob] += 1;
+  std::cout << "bob is " << ages.at("bob") << ", carol is " << ages.find(std::string_view("carol"))->second
+            << ", dave is " << (ages.contains("dave") ? "known" : "unknown") << '\n';
+  for (const auto &p : ages)
+    std::cout << p.first << ": " << p.second << '\n';
+
+  // Random inserts and erases, checked against std::unordered_map.
+  flat_hash_map<int, int> m;
+  std::unordered_map<int, int> ref;
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> key(0, 5000);
+  bool ok = true;
+  for (int n = 0; n < 200000; n += 1) {
+    int k = key(rng);
+    switch (rng() % 3) {
+    case 0:
+      m[k] += n;
+      ref[k] += n;
+      break;
+    case 1:
+      ok &= m.erase(k) == ref.erase(k);
+      break;
+    default: {
+      auto i = m.find(k);
+      auto j = ref.find(k);
+      ok &= (i == m.end()) == (j == ref.end()) && (i == m.end() || i->second == j->second);
+    }
+    }
+  }
+  std::size_t seen = 0;
+  for (const auto &p : m) {
+    ok &= ref.count(p.first) && ref[p.first] == p.second;
+    seen += 1;
+  }
+  ok &= seen == ref.size() && m.size() == ref.size();
+  std::cout << "Random operations: " << m.size() << " elements, capacity " << m.capacity()
+            << ", " << (ok ? "matches" : "DOESN'T MATCH") << " std::unordered_map\n";
+
+  return ok ? 0 : 1;
+}
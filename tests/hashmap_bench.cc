@@ -0,0 +1,88 @@
+// Word counting with std::map, std::unordered_map and flat_hash_map.
+// Prints CSV: map,tokens,distinct,seconds,ns_per_token
+//
+// Usage: hashmap_bench [file, default words.txt] [times to repeat it, default 100]
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <cstdlib>
+
+#include "useful/flat_hash_map.hpp"
+#include "useful/tokenize.hpp"
+#include "useful/reader.hpp"
+
+using namespace useful;
+
+template<class Count>
+void measure(const char *name, const std::vector<std::string_view> &words, Count count) {
+  using clock = std::chrono::steady_clock;
+  double best = 1e100;
+  std::size_t distinct = 0;
+  for (int runs = 0; runs < 3; runs += 1) {
+    auto start = clock::now();
+    distinct = count();
+    std::chrono::duration<double> secs = clock::now() - start;
+    if (secs.count() < best)
+      best = secs.count();
+  }
+  std::cout << name << ',' << words.size() << ',' << distinct << ',' << best << ','
+            << best * 1e9 / words.size() << '\n';
+}
+
+int main(int argc, char **argv) {
+  mapped_file file(argc > 1 ? argv[1] : "words.txt");
+  int times = argc > 2 ? std::atoi(argv[2]) : 100;
+
+  std::string text;
+  text.reserve((file.size() + 1) * times);
+  for (int n = 0; n < times; n += 1) {
+    text.append(file.view());
+    text.push_back('\n');
+  }
+  std::vector<std::string_view> words;
+  for_each_token(text, " \t\n", [&](std::string_view w) { words.push_back(w); });
+
+  std::cout << "map,tokens,distinct,seconds,ns_per_token\n";
+  measure("std::map", words, [&] {
+      std::map<std::string, int, std::less<>> m;
+      for (auto w : words) {
+        auto i = m.find(w);
+        if (i == m.end())
+          m.emplace(w, 1);
+        else
+          i->second += 1;
+      }
+      return m.size();
+    });
+  measure("std::unordered_map", words, [&] {
+      std::unordered_map<std::string, int> m;
+      for (auto w : words)
+        m[std::string(w)] += 1;
+      return m.size();
+    });
+  measure("std::unordered_map<string_view>", words, [&] {
+      std::unordered_map<std::string_view, int> m;
+      for (auto w : words)
+        m[w] += 1;
+      return m.size();
+    });
+  measure("flat_string_map", words, [&] {
+      flat_string_map<int> m;
+      for (auto w : words)
+        m[w] += 1;
+      return m.size();
+    });
+  measure("flat_hash_map<string_view>", words, [&] {
+      flat_hash_map<std::string_view, int> m;
+      for (auto w : words)
+        m[w] += 1;
+      return m.size();
+    });
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "useful/heavy_hitters.hpp"
+#include "useful/flat_hash_map.hpp"
+#include "useful/tokenize.hpp"
+#include "useful/reader.hpp"
+
+using namespace useful;
+
+using exact_counts = flat_hash_map<std::string_view, std::uint64_t>;
+
+// Checks the guarantees of ss against the exact counts of everything
+// added to it.
+bool check(const char *what, const space_saving<std::string_view> &ss,
+           const exact_counts &exact) {
+  bool reported = true, bounded = true;
+  std::size_t heavy = 0;
+  std::uint64_t threshold = ss.total() / ss.capacity();
+  auto top = ss.top(ss.size());
+  flat_hash_map<std::string_view, bool> monitored;
+  for (const auto &e : top)
+    monitored[e.key] = true;
+  for (const auto &kv : exact) {
+    if (kv.second > threshold) {
+      heavy += 1;
+      if (!monitored.contains(kv.first))
+        reported = false;
+    }
+    if (ss.estimate(kv.first) < kv.second)
+      bounded = false;
+  }
+  for (const auto &e : top) {
+    auto i = exact.find(e.key);
+    std::uint64_t truth = i == exact.end() ? 0 : i->second;
+    if (e.guaranteed() > truth || truth > e.count)
+      bounded = false;
+  }
+  std::cout << what << ": " << ss.size() << " of " << exact.size() << " words monitored, "
+            << (reported ? "all " : "NOT ALL ") << heavy << " words seen more than " << threshold
+            << " times reported, counts " << (bounded ? "within" : "OUTSIDE") << " bounds. Top: "
+            << top.front().key << " (" << top.front().count << ")\n";
+  return reported && bounded;
+}
+
+bool check(const char *what, const count_min_sketch<std::string_view> &cms,
+           const exact_counts &exact) {
+  bool over = true;
+  std::uint64_t maxerr = 0;
+  for (const auto &kv : exact) {
+    std::uint64_t est = cms.estimate(kv.first);
+    if (est < kv.second)
+      over = false;
+    else
+      maxerr = std::max(maxerr, est - kv.second);
+  }
+  std::cout << what << ": " << (over ? "never undercounts" : "UNDERCOUNTS")
+            << ", overcounts by at most " << maxerr << " of " << cms.total() << '\n';
+  return over;
+}
+
+int main(void) {
+  mapped_file corpus("words.txt");
+  std::vector<std::string_view> words;
+  for_each_token(corpus.view(), " \t\n", [&](std::string_view w) { words.push_back(w); });
+
+  exact_counts exact;
+  for (auto w : words)
+    exact[w] += 1;
+
+  bool ok = true;
+  space_saving<std::string_view> ss(400);
+  auto cms = count_min_sketch<std::string_view>(64, 4);
+  for (auto w : words) {
+    ss.add(w);
+    cms.add(w);
+  }
+  ok &= check("space_saving", ss, exact);
+  ok &= check("count_min", cms, exact);
+
+  // Halves summarized separately and merged, including one with a
+  // smaller capacity.
+  std::size_t half = words.size() / 2;
+  space_saving<std::string_view> a(400), b(400), c(250);
+  auto cms_a = count_min_sketch<std::string_view>(64, 4), cms_b = cms_a;
+  for (std::size_t n = 0; n < words.size(); n += 1) {
+    (n < half ? a : b).add(words[n]);
+    (n < half ? cms_a : cms_b).add(words[n]);
+    if (n >= half)
+      c.add(words[n]);
+  }
+  space_saving<std::string_view> a2 = a;
+  a.merge(b);
+  ok &= check("space_saving merged", a, exact);
+  a2.merge(c);
+  ok &= check("space_saving merged with a smaller one", a2, exact);
+  cms_a.merge(cms_b);
+  ok &= check("count_min merged", cms_a, exact);
+
+  // A small summary merged into an empty bigger one, which has free
+  // counters but has still lost keys, then merged again.
+  space_saving<std::string_view> small(100), big(1000), other(400);
+  for (std::size_t n = 0; n < words.size(); n += 1)
+    (n < half ? small : other).add(words[n]);
+  big.merge(small);
+  other.merge(big);
+  ok &= check("space_saving merged twice", other, exact);
+  for (std::size_t n = half; n < words.size(); n += 1)
+    big.add(words[n]);
+  ok &= check("space_saving added to after a merge", big, exact);
+
+  return ok ? 0 : 1;
+}
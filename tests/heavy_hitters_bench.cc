@@ -0,0 +1,121 @@
+// Compares exact word counting with space_saving and count_min_sketch
+// on a Zipf-distributed stream of words. To get a high cardinality,
+// the vocabulary is every word of words.txt with a numeric suffix.
+// Prints CSV: method,tokens,distinct,seconds,ns_per_token,memory_bytes,top_recall,max_rel_error
+// memory_bytes is an estimate of the size of the counting structure.
+//
+// Usage: heavy_hitters_bench [millions of tokens, default 10] [vocabulary size, default 1000000]
+//                            [top k, default 100] [capacity, default 2000]
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "useful/heavy_hitters.hpp"
+#include "useful/flat_hash_map.hpp"
+#include "useful/tokenize.hpp"
+#include "useful/reader.hpp"
+
+using namespace useful;
+using clock_type = std::chrono::steady_clock;
+
+int main(int argc, char **argv) {
+  std::size_t ntokens = (argc > 1 ? std::atoi(argv[1]) : 10) * 1000000UL;
+  std::size_t nvocab = argc > 2 ? std::atoi(argv[2]) : 1000000;
+  std::size_t topk = argc > 3 ? std::atoi(argv[3]) : 100;
+  std::size_t capacity = argc > 4 ? std::atoi(argv[4]) : 2000;
+
+  mapped_file file("words.txt");
+  std::vector<std::string_view> base;
+  for_each_token(file.view(), " \t\n", [&](std::string_view w) { base.push_back(w); });
+  std::sort(base.begin(), base.end());
+  base.erase(std::unique(base.begin(), base.end()), base.end());
+  std::shuffle(base.begin(), base.end(), std::mt19937(1));
+  std::vector<std::string> vocab;
+  vocab.reserve(nvocab);
+  for (std::size_t n = 0; n < nvocab; n += 1)
+    vocab.push_back(std::string(base[n % base.size()]) + '-' + std::to_string(n / base.size()));
+
+  // Zipf with s = 1: rank r has weight 1 / r
+  std::vector<double> cdf(nvocab);
+  double sum = 0;
+  for (std::size_t r = 0; r < nvocab; r += 1)
+    cdf[r] = sum += 1.0 / (r + 1);
+  std::mt19937_64 rng(7);
+  std::uniform_real_distribution<double> u(0, sum);
+  std::vector<std::string_view> stream;
+  stream.reserve(ntokens);
+  for (std::size_t n = 0; n < ntokens; n += 1)
+    stream.push_back(vocab[std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin()]);
+
+  std::cout << "method,tokens,distinct,seconds,ns_per_token,memory_bytes,top_recall,max_rel_error\n";
+
+  auto start = clock_type::now();
+  flat_hash_map<std::string_view, std::uint64_t> exact;
+  for (auto w : stream)
+    exact[w] += 1;
+  std::chrono::duration<double> secs = clock_type::now() - start;
+  std::cout << "exact," << ntokens << ',' << exact.size() << ',' << secs.count() << ','
+            << secs.count() * 1e9 / ntokens << ','
+            << exact.capacity() * (sizeof(std::pair<std::string_view, std::uint64_t>) + 1)
+            << ",1,0\n";
+
+  std::vector<std::pair<std::string_view, std::uint64_t>> truth(exact.begin(), exact.end());
+  topk = std::min(topk, truth.size());
+  std::partial_sort(truth.begin(), truth.begin() + topk, truth.end(),
+                    [](auto &a, auto &b) { return a.second > b.second; });
+  truth.resize(topk);
+
+  start = clock_type::now();
+  space_saving<std::string_view> ss(capacity);
+  for (auto w : stream)
+    ss.add(w);
+  secs = clock_type::now() - start;
+  auto top = ss.top(topk);
+  std::size_t found = 0;
+  double maxerr = 0;
+  for (auto &t : truth) {
+    found += std::count_if(top.begin(), top.end(), [&](auto &e) { return e.key == t.first; });
+    maxerr = std::max(maxerr, double(ss.estimate(t.first) - t.second) / t.second);
+  }
+  std::cout << "space_saving," << ntokens << ',' << ss.size() << ',' << secs.count() << ','
+            << secs.count() * 1e9 / ntokens << ','
+            << capacity * (sizeof(std::string_view) * 2 + 40) << ','
+            << double(found) / topk << ',' << maxerr << '\n';
+
+  // Two halves summarized separately and merged, like two threads would.
+  space_saving<std::string_view> a(capacity), b(capacity);
+  for (std::size_t n = 0; n < ntokens; n += 1)
+    (n < ntokens / 2 ? a : b).add(stream[n]);
+  a.merge(b);
+  top = a.top(topk);
+  found = 0;
+  maxerr = 0;
+  for (auto &t : truth) {
+    found += std::count_if(top.begin(), top.end(), [&](auto &e) { return e.key == t.first; });
+    maxerr = std::max(maxerr, double(a.estimate(t.first) - t.second) / t.second);
+  }
+  std::cout << "space_saving_merged," << ntokens << ',' << a.size() << ",,,,"
+            << double(found) / topk << ',' << maxerr << '\n';
+
+  start = clock_type::now();
+  auto cms = count_min_sketch<std::string_view>::with_error(0.0005, 0.001);
+  for (auto w : stream)
+    cms.add(w);
+  secs = clock_type::now() - start;
+  maxerr = 0;
+  for (auto &t : truth)
+    maxerr = std::max(maxerr, double(cms.estimate(t.first) - t.second) / t.second);
+  std::cout << "count_min," << ntokens << ",," << secs.count() << ','
+            << secs.count() * 1e9 / ntokens << ','
+            << cms.width() * cms.depth() * sizeof(std::uint64_t) << ",,"
+            << maxerr << '\n';
+
+  return 0;
+}
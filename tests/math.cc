@@ -1,5 +1,6 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
 #include "useful/math.hpp"
 #include "useful/range.hpp"
@@ -22,5 +23,25 @@ int main(void) {
 	
 	std::cout << "Product of vector minus last element: " << product(take(foo, -1)) << '\n';
 	
+	std::vector<float> tenths(1000000, 0.1f);
+	std::cout << "\nSum of a million 0.1f, should be about 100000:\n";
+	std::cout << "serial: " << std::accumulate(tenths.begin(), tenths.end(), 0.0f) << '\n';
+	std::cout << "fast: " << sum(tenths) << '\n';
+	std::cout << "pairwise: " << sum(tenths, summation::pairwise) << '\n';
+	std::cout << "kahan: " << sum(tenths, summation::kahan) << '\n';
+	
+	std::vector<double> series(3000000);
+	for (std::size_t i = 0; i < series.size(); i += 1)
+		series[i] = 1.0 / (i + 1);
+	double one = parallel_sum(series, 1);
+	bool same = true;
+	for (unsigned threads : {2, 3, 8})
+		same = same && parallel_sum(series, threads) == one;
+	std::cout << "\nParallel harmonic sum: " << one << ", same with 1, 2, 3 and 8 threads: "
+	          << (same ? "yes" : "no") << '\n';
+	std::cout << "Parallel product of vector: " << parallel_product(foo) << '\n';
+	std::cout << "Parallel max of series: "
+	          << parallel_reduce(series, 0.0, [](double a, double b) { return std::max(a, b); }) << '\n';
+	
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+// Compares std::accumulate with sum() and product() over contiguous
+// arrays, the accuracy of the summation modes, and one-pass stats
+// against the usual several passes. Prints CSV:
+// type,method,elements,seconds,gb_per_second,result,relative_error
+//
+// Usage: math_bench [elements, default 16M]
+
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <functional>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#include "useful/math.hpp"
+#include "useful/stats.hpp"
+
+using namespace useful;
+using clock_type = std::chrono::steady_clock;
+
+static volatile double sink;
+static void do_not_discard(double x) { sink = x; }
+
+template<class T, class F>
+void measure(const char *type, const char *method, const std::vector<T> &v,
+             long double exact, F f) {
+  double best = 1e100;
+  T res = 0;
+  for (int runs = 0; runs < 7; runs += 1) {
+    auto start = clock_type::now();
+    res = f(v);
+    std::chrono::duration<double> secs = clock_type::now() - start;
+    best = std::min(best, secs.count());
+  }
+  long double err = exact == 0 ? 0 : std::fabs((res - exact) / exact);
+  std::cout << type << ',' << method << ',' << v.size() << ',' << best << ','
+            << v.size() * sizeof(T) / best / 1e9 << ',' << res << ',' << static_cast<double>(err) << '\n';
+}
+
+template<class T>
+void run(const char *type, std::size_t n) {
+  std::mt19937_64 rng(42);
+  std::vector<T> v(n);
+  if constexpr (std::is_floating_point<T>::value) {
+    std::uniform_real_distribution<T> dist(0, 1);
+    for (auto &x : v)
+      x = dist(rng);
+  } else {
+    std::uniform_int_distribution<T> dist(0, 100);
+    for (auto &x : v)
+      x = dist(rng);
+  }
+
+  long double exact = 0;
+  for (auto x : v)
+    exact += x;
+
+  measure(type, "accumulate", v, exact,
+          [](const auto &v) { return std::accumulate(v.begin(), v.end(), T(0)); });
+  measure(type, "sum", v, exact, [](const auto &v) { return sum(v); });
+  measure(type, "parallel_sum", v, exact, [](const auto &v) { return parallel_sum(v); });
+  if constexpr (std::is_floating_point<T>::value) {
+    measure(type, "sum_pairwise", v, exact, [](const auto &v) { return sum(v, summation::pairwise); });
+    measure(type, "sum_kahan", v, exact, [](const auto &v) { return sum(v, summation::kahan); });
+
+    // Mean, variance, min, max and median: one pass with stats, or the
+    // usual several passes plus a copy for nth_element.
+    measure(type, "stats", v, exact, [](const auto &v) {
+      auto s = summarize(v);
+      do_not_discard(s.variance() + s.min() + s.max() + s.median());
+      return T(s.sum());
+    });
+    measure(type, "stats_multi_pass", v, exact, [](const auto &v) {
+      T total = std::accumulate(v.begin(), v.end(), T(0));
+      T mean = total / v.size(), var = 0;
+      for (auto x : v)
+        var += (x - mean) * (x - mean);
+      auto mm = std::minmax_element(v.begin(), v.end());
+      std::vector<T> copy(v);
+      std::nth_element(copy.begin(), copy.begin() + copy.size() / 2, copy.end());
+      do_not_discard(double(var + *mm.first + *mm.second + copy[copy.size() / 2]));
+      return total;
+    });
+
+    // Values near 1 so the product neither overflows nor underflows.
+    for (auto &x : v)
+      x = 1 + (x - T(0.5)) / n;
+    exact = 1;
+    for (auto x : v)
+      exact *= x;
+    measure(type, "accumulate_product", v, exact, [](const auto &v) {
+      return std::accumulate(v.begin(), v.end(), T(1), std::multiplies<T>());
+    });
+    measure(type, "product", v, exact, [](const auto &v) { return product(v); });
+    measure(type, "parallel_product", v, exact, [](const auto &v) { return parallel_product(v); });
+  }
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16 << 20;
+
+  std::cout << "type,method,elements,seconds,gb_per_second,result,relative_error\n";
+  run<float>("float", n);
+  run<double>("double", n);
+  run<int>("int", n);
+  run<long>("long", n);
+  return 0;
+}
@@ -0,0 +1,233 @@
+// Microbenchmarks of every libuseful component, all measured the same
+// way with useful/bench.hpp. Prints its CSV; see benchmark for the
+// columns. Counter columns are empty if perf_event_open isn't allowed.
+//
+// Usage: micro_bench [only run benchmarks whose names contain this]
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <numeric>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+
+#include "useful/bench.hpp"
+#include "useful/math.hpp"
+#include "useful/stats.hpp"
+#include "useful/string.hpp"
+#include "useful/tokenize.hpp"
+#include "useful/reader.hpp"
+#include "useful/string_pool.hpp"
+#include "useful/flat_hash_map.hpp"
+#include "useful/heavy_hitters.hpp"
+#include "useful/combos.hpp"
+#include "useful/range.hpp"
+#include "useful/sort.hpp"
+#include "useful/arena.hpp"
+#include "useful/mutex.hpp"
+#include "useful/thread.hpp"
+
+using namespace useful;
+
+int main(int argc, char **argv) {
+  std::string only = argc > 1 ? argv[1] : "";
+  benchmark b;
+  auto run = [&](const std::string &name, auto f, double bytes = 0, double items = 0) {
+    if (name.find(only) != std::string::npos)
+      b.run(name, f, bytes, items);
+  };
+  if (!b.have_counters())
+    std::cerr << "Hardware counters unavailable; check /proc/sys/kernel/perf_event_paranoid\n";
+
+  std::mt19937_64 rng(7);
+  std::vector<double> doubles(1 << 20);
+  std::uniform_real_distribution<double> unit(0, 1);
+  for (auto &x : doubles)
+    x = unit(rng);
+  const double dbytes = doubles.size() * sizeof(double);
+
+  mapped_file file("words.txt");
+  std::string_view text = file.view();
+  std::vector<std::string_view> words;
+  for_each_token(text, " \t\n", [&](std::string_view w) { words.push_back(w); });
+  const double nwords = words.size();
+
+  // math and stats
+  run("math/accumulate", [&] { return std::accumulate(doubles.begin(), doubles.end(), 0.0); },
+      dbytes, doubles.size());
+  run("math/sum", [&] { return sum(doubles); }, dbytes, doubles.size());
+  run("math/sum_pairwise", [&] { return sum(doubles, summation::pairwise); }, dbytes, doubles.size());
+  run("math/parallel_sum", [&] { return parallel_sum(doubles); }, dbytes, doubles.size());
+  run("math/product", [&] { return product(doubles); }, dbytes, doubles.size());
+  run("stats/summarize", [&] { return summarize(doubles).variance(); }, dbytes, doubles.size());
+
+  // string
+  run("string/for_each_token", [&] {
+      std::size_t n = 0;
+      for_each_token(text, " \t\n", [&](std::string_view) { n += 1; });
+      return n;
+    }, text.size(), nwords);
+  std::string textstr(text);
+  run("string/tokenize", [&] { return tokenize(textstr, " \t\n").size(); }, text.size(), nwords);
+  run("string/splitv", [&] { return splitv(textstr, "\\s+").size(); }, text.size(), nwords);
+  run("string/parallel_tokenize", [&] { return parallel_tokenize(text, " \t\n").size(); },
+      text.size(), nwords);
+  run("string/regex_cache_hit", [&] { return default_regex_cache().get("\\s+").get(); }, 0, 1);
+
+  // reader
+  run("reader/next_line", [&] {
+      record_reader r("words.txt");
+      std::string_view line;
+      std::size_t n = 0;
+      while (r.next_line(line))
+        n += 1;
+      return n;
+    }, text.size());
+
+  // string_pool
+  run("string_pool/intern", [&] {
+      string_pool pool;
+      for (auto w : words)
+        pool.intern(w);
+      return pool.size();
+    }, text.size(), nwords);
+
+  // flat_hash_map
+  run("flat_hash_map/count_words", [&] {
+      flat_string_map<int> m;
+      for (auto w : words)
+        m[w] += 1;
+      return m.size();
+    }, text.size(), nwords);
+  flat_string_map<int> counted;
+  for (auto w : words)
+    counted[w] += 1;
+  run("flat_hash_map/find", [&] {
+      long n = 0;
+      for (auto w : words)
+        n += counted.find(w)->second;
+      return n;
+    }, 0, nwords);
+
+  // heavy_hitters
+  run("heavy_hitters/space_saving", [&] {
+      space_saving<std::string, string_hash, std::equal_to<>> ss(1000);
+      for (auto w : words)
+        ss.add(w);
+      return ss.total();
+    }, 0, nwords);
+  run("heavy_hitters/count_min", [&] {
+      count_min_sketch<std::string_view> cms(4096, 4);
+      for (auto w : words)
+        cms.add(w);
+      return cms.total();
+    }, 0, nwords);
+
+  // combos
+  std::vector<int> items(20);
+  std::iota(items.begin(), items.end(), 0);
+  combinations<int> c(items);
+  run("combos/lazy_combos_20_5", [&] {
+      long n = 0;
+      for (auto combo : c.lazy_combos(5))
+        n += combo[0];
+      return n;
+    }, 0, ncr(20, 5));
+  run("combos/combos_flat_20_5", [&] { return c.combos_flat(5).size(); }, 0, ncr(20, 5));
+  run("combos/ncr", [&] {
+      std::uint64_t n = 0;
+      for (int i = 0; i < 68; i += 1)
+        n += ncr(std::uint64_t(67), std::uint64_t(i));
+      return n;
+    }, 0, 68);
+
+  // range
+  run("range/pipeline", [&] {
+      double s = 0;
+      for (auto x : doubles | filter([](double x) { return x < 0.5; }) | transform([](double x) { return x * x; }))
+        s += x;
+      return s;
+    }, dbytes, doubles.size());
+  run("range/loop", [&] {
+      double s = 0;
+      for (auto x : doubles)
+        if (x < 0.5)
+          s += x * x;
+      return s;
+    }, dbytes, doubles.size());
+  std::list<int> list(items.begin(), items.end());
+  run("range/take_list", [&] {
+      long n = 0;
+      auto t = take(list, 10);
+      for (auto it = t.begin(); it != t.end(); ++it)
+        n += *it;
+      return n;
+    }, 0, 10);
+
+  // sort
+  std::vector<int> unsorted(10000);
+  for (auto &x : unsorted)
+    x = rng() % 100000;
+  std::vector<int> work;
+  monotonic_arena arena;
+  run("sort/std_stable_sort", [&] {
+      work = unsorted;
+      std::stable_sort(work.begin(), work.end());
+      return work[0];
+    }, 0, unsorted.size());
+  run("sort/merge_sort", [&] {
+      work = unsorted;
+      merge_sort(work.begin(), work.end());
+      return work[0];
+    }, 0, unsorted.size());
+  run("sort/merge_sort_arena", [&] {
+      work = unsorted;
+      merge_sort(work.begin(), work.end(), std::less<int>(), arena_allocator<int>(arena));
+      arena.reset();
+      return work[0];
+    }, 0, unsorted.size());
+  run("sort/quick_sort", [&] {
+      work = unsorted;
+      quick_sort(work.begin(), work.end());
+      return work[0];
+    }, 0, unsorted.size());
+
+  // arena
+  run("arena/new_delete_64", [&] {
+      void *ps[64];
+      for (auto &p : ps)
+        p = ::operator new(64);
+      for (auto p : ps)
+        ::operator delete(p);
+      return ps[0];
+    }, 0, 64);
+  run("arena/monotonic_64", [&] {
+      void *ps[64];
+      for (auto &p : ps)
+        p = arena.allocate(64);
+      arena.reset();
+      return ps[0];
+    }, 0, 64);
+  pool_arena pool;
+  run("arena/pool_list", [&] {
+      std::list<int, arena_allocator<int, pool_arena>> l{arena_allocator<int, pool_arena>(pool)};
+      for (int i = 0; i < 64; i += 1)
+        l.push_back(i);
+      return l.size();
+    }, 0, 64);
+
+  // mutex and thread
+  spin_lock spin;
+  ticket_lock ticket;
+  std::mutex mutex;
+  run("mutex/spin_lock", [&] { std::lock_guard<spin_lock> g(spin); }, 0, 1);
+  run("mutex/ticket_lock", [&] { std::lock_guard<ticket_lock> g(ticket); }, 0, 1);
+  run("mutex/std_mutex", [&] { std::lock_guard<std::mutex> g(mutex); }, 0, 1);
+  run("thread/run_threads_4", [&] { run_threads(4, [](unsigned) {}); }, 0, 1);
+
+  return 0;
+}
@@ -1,5 +1,9 @@
 #include <vector>
+#include <list>
+#include <forward_list>
+#include <string>
 #include <iostream>
+#include <stdexcept>
 #include "useful/range.hpp"
 
 using namespace useful;
@@ -57,6 +61,101 @@ int main(void) {
 		std::cout << i << ',';
 	std::cout << '\n';
 
+	std::cout << "\nTake 3 of drop 1:\n";
+	for (auto i : take(drop(cfoo, 1), 3))
+		std::cout << i << ',';
+	std::cout << '\n';
+	for (auto i : bar | drop(1) | take(3))
+		std::cout << i << ',';
+	std::cout << '\n';
+
+	std::cout << "\nTake 2 of a temporary:\n";
+	for (auto i : take(std::vector<int>{11, 12, 13}, 2))
+		std::cout << i << ',';
+	std::cout << '\n';
+
+	std::cout << "\nSquares of the odd elements, then of the reversed odd elements:\n";
+	for (auto i : bar | filter([](int x) { return x % 2; }) | transform([](int x) { return x * x; }))
+		std::cout << i << ',';
+	std::cout << '\n';
+	for (auto i : rev(transform(cfoo, [](int x) { return x * x; })) | filter([](int x) { return x % 2; }))
+		std::cout << i << ',';
+	std::cout << '\n';
+
+	std::vector<int> nums;
+	for (int i = 0; i < 10; i += 1)
+		nums.push_back(i);
+	std::cout << "\nEvery 3rd of 0-9: ";
+	for (auto i : stride(nums, 3))
+		std::cout << i << ',';
+	auto s3 = stride(nums, 3);
+	std::cout << " (" << s3.size() << " elements, last " << s3.end()[-1] << ")\n";
+
+	std::cout << "Chunks of 4: ";
+	for (auto c : nums | chunk(4)) {
+		std::cout << '[';
+		for (auto i : c)
+			std::cout << i << ',';
+		std::cout << ']';
+	}
+	std::cout << '\n';
+	try {
+		chunk(nums, 0);
+	} catch (std::invalid_argument &e) {
+		std::cout << "Chunks of 0: " << e.what() << '\n';
+	}
+
+	// Random access all the way down
+	auto squares = nums | drop(2) | stride(2) | transform([](int x) { return x * x; });
+	static_assert(std::is_same<std::iterator_traits<decltype(squares.begin())>::iterator_category,
+	                           std::random_access_iterator_tag>::value, "should be random access");
+	std::cout << "Squares of every other element from 2: " << squares.size() << " of them, squares[2] = "
+	          << squares[2] << ", from the end: ";
+	for (auto i : rev(squares))
+		std::cout << i << ',';
+	std::cout << '\n';
+
+	std::cout << "\nZip and enumerate:\n";
+	std::list<std::string> names{"one", "two", "three", "four", "five", "six"};
+	for (auto [i, pair] : enumerate(zip(cfoo, names))) {
+		auto [n, name] = pair;
+		std::cout << i << ": " << n << ' ' << name << '\n';
+	}
+	for (auto [a, b] : zip(bar, cfoo))
+		a += b;
+	for (auto i : bar)
+		std::cout << i << ',';
+	std::cout << '\n';
+	for (auto [i, name] : names | filter([](const std::string &s) { return s.size() == 3; }) | enumerate())
+		std::cout << i << ':' << name << ',';
+	std::cout << '\n';
+
+	std::cout << "\nSizes: drop(cfoo, 2) " << drop(cfoo, 2).size() << ", take(cfoo, 2) " << take(cfoo, 2).size()
+	          << ", take(cfoo, 10) " << take(cfoo, 10).size() << ", drop(cfoo, -1) " << drop(cfoo, -1).size() << '\n';
+
+	std::forward_list<int> fl{1, 2, 3, 4, 5, 6};
+	auto mid = take(drop(fl, 1), -1);
+	std::cout << "Middle of a forward_list: ";
+	for (auto i : mid)
+		std::cout << i << ',';
+	std::cout << " (" << mid.size() << " elements)\n";
+
+	std::cout << "\nSplit into 3: ";
+	for (auto part : split_into(nums, 3)) {
+		std::cout << '[';
+		for (auto i : part)
+			std::cout << i << ',';
+		std::cout << ']';
+	}
+	std::cout << "\nSplit into 4: ";
+	for (auto part : split_into(names, 4)) {
+		std::cout << '[';
+		for (const auto &name : part)
+			std::cout << name << ',';
+		std::cout << ']';
+	}
+	std::cout << '\n';
+
 	// These should fail to compile:
 	//  auto baz = take_adaptor<const std::vector<int>>(cfoo, 1);
 	//  auto baz = take_adaptor<std::vector<int>>(cfoo, 1);
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "useful/reader.hpp"
+
+using namespace useful;
+
+// Reads a file both memory mapped and through a pipe with a tiny
+// block size, so that most records straddle a block boundary, and
+// checks that both give the same results.
+template<class Next>
+std::vector<std::string> readall(record_reader &in, Next next) {
+  std::vector<std::string> recs;
+  std::string_view rec;
+  while (next(in, rec))
+    recs.emplace_back(rec);
+  return recs;
+}
+
+template<class Next>
+bool compare(const char *file, const char *what, Next next) {
+  record_reader mapped(file);
+  auto a = readall(mapped, next);
+
+  std::string cmd = std::string("cat ") + file;
+  FILE *pipe = popen(cmd.c_str(), "r");
+  record_reader piped(fileno(pipe), 16);
+  auto b = readall(piped, next);
+  pclose(pipe);
+
+  std::cout << what << ": " << a.size() << " mapped ("
+            << (mapped.mapped() ? "yes" : "no") << "), " << b.size()
+            << " piped (" << (piped.mapped() ? "yes" : "no") << "), "
+            << (a == b ? "same" : "DIFFERENT") << '\n';
+  return a == b;
+}
+
+// A reader given an open file starts at the file's current offset.
+bool from_offset(const char *file) {
+  record_reader whole(file);
+  auto a = readall(whole, [](auto &in, auto &r) { return in.next_line(r); });
+  if (a.empty())
+    return true;
+  int fd = open(file, O_RDONLY);
+  lseek(fd, a[0].size() + 1, SEEK_SET);
+  record_reader rest(fd);
+  auto b = readall(rest, [](auto &in, auto &r) { return in.next_line(r); });
+  close(fd);
+  bool same = std::equal(a.begin() + 1, a.end(), b.begin(), b.end());
+  std::cout << "From after the first line: " << b.size() << " lines, "
+            << (same ? "same" : "DIFFERENT") << '\n';
+  return same;
+}
+
+int main(int argc, char **argv) {
+  const char *file = argc > 1 ? argv[1] : "words.txt";
+
+  bool ok = compare(file, "Lines", [](auto &in, auto &r) { return in.next_line(r); });
+  ok &= compare(file, "Words", [](auto &in, auto &r) { return in.next_word(r); });
+  ok &= compare(file, "Records split on 'e'",
+                [](auto &in, auto &r) { return in.next_record(r, 'e'); });
+  ok &= from_offset(file);
+
+  return ok ? 0 : 1;
+}
@@ -3,6 +3,8 @@
 #include <iterator>
 
 #include "useful/string.hpp"
+#include "useful/tokenize.hpp"
+#include "useful/reader.hpp"
 
 int main(void) {
   std::string test1 = "this is\t   a test\tstring to\tsplit up.";
@@ -23,5 +25,18 @@ int main(void) {
   for (auto &w : wordv)
     std::cout << w << '\n';
 
+  // The pattern compiled for the splitv() above should be reused here.
+  wordv = useful::splitv(test2, "the");
+  auto &cache = useful::default_regex_cache();
+  std::cout << "Regex cache: " << cache.hits() << " hits, "
+            << cache.misses() << " misses, " << cache.size() << " cached.\n";
+
+  useful::mapped_file corpus("words.txt");
+  std::size_t serial = 0;
+  useful::for_each_token(corpus.view(), " \t\n", [&](std::string_view) { serial += 1; });
+  auto parallel = useful::parallel_tokenize(corpus.view(), " \t\n", 4);
+  std::cout << "words.txt has " << serial << " words, " << parallel.size()
+            << " when tokenized on 4 threads.\n";
+
   return 0;
 } 
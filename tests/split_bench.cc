@@ -0,0 +1,139 @@
+// Measures split(), splitv(), tokenize() and the string_view tokenizers
+// on words.txt and on generated CSV and log line corpora. Prints CSV:
+// corpus,method,bytes,tokens,seconds,mb_per_s,ns_per_token,allocs_per_token
+//
+// Usage: split_bench [corpus size in MB, default 1]
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <regex>
+#include <random>
+#include <chrono>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <cstdlib>
+#include <new>
+
+#include "useful/string.hpp"
+#include "useful/tokenize.hpp"
+#include "useful/reader.hpp"
+
+using namespace useful;
+
+// Count heap allocations.
+static std::atomic<unsigned long> allocations{0};
+
+void *operator new(std::size_t n) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+struct corpus {
+  std::string name;
+  std::string text;
+  std::string delims;   // For tokenize() and friends
+  std::string pattern;  // The same thing as a regular expression
+};
+
+// Lines of fields separated by commas, each field around width
+// characters long.
+corpus make_csv(std::size_t bytes, int width, int fields) {
+  std::mt19937 rng(width * 31 + fields);
+  std::uniform_int_distribution<int> len(width / 2 + 1, width + width / 2);
+  std::uniform_int_distribution<int> ch('a', 'z');
+  corpus c{"csv-w" + std::to_string(width) + "-f" + std::to_string(fields), {}, ",\n", "[,\\n]"};
+  c.text.reserve(bytes + 256);
+  while (c.text.size() < bytes) {
+    for (int f = 0; f < fields; f += 1) {
+      int n = len(rng);
+      for (int i = 0; i < n; i += 1)
+        c.text.push_back(ch(rng));
+      c.text.push_back(f == fields - 1 ? '\n' : ',');
+    }
+  }
+  return c;
+}
+
+// Space separated log lines.
+corpus make_log(std::size_t bytes) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> num(0, 99999);
+  static const char *levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+  corpus c{"log", {}, " \n", "[ \\n]+"};
+  c.text.reserve(bytes + 256);
+  while (c.text.size() < bytes) {
+    int n = num(rng);
+    c.text += "2026-10-19T12:" + std::to_string(n % 60) + ":" + std::to_string(n % 61)
+      + " " + levels[n % 4] + " worker-" + std::to_string(n % 32)
+      + " request id=" + std::to_string(n) + " path=/api/v1/items/"
+      + std::to_string(n * 7) + " took " + std::to_string(n % 997) + "ms\n";
+  }
+  return c;
+}
+
+// Runs fn, which returns a token count, enough times to take at least
+// 0.2 seconds and prints the best run.
+void measure(const corpus &c, const char *method, std::function<std::size_t()> fn) {
+  using clock = std::chrono::steady_clock;
+  double best = 1e100, total = 0;
+  std::size_t tokens = 0;
+  unsigned long allocs = 0;
+  for (int runs = 0; runs < 3 || total < 0.2; runs += 1) {
+    unsigned long a = allocations.load();
+    auto start = clock::now();
+    tokens = fn();
+    std::chrono::duration<double> secs = clock::now() - start;
+    allocs = allocations.load() - a;
+    total += secs.count();
+    if (secs.count() < best)
+      best = secs.count();
+  }
+  std::cout << c.name << ',' << method << ',' << c.text.size() << ',' << tokens << ','
+            << best << ',' << c.text.size() / best / 1e6 << ','
+            << best * 1e9 / tokens << ',' << double(allocs) / tokens << '\n';
+}
+
+void run(const corpus &c) {
+  std::regex re(c.pattern);
+  measure(c, "split-regex", [&] {
+      std::vector<std::string> out;
+      split(c.text, re, std::back_inserter(out));
+      return out.size();
+    });
+  measure(c, "split-pattern", [&] {
+      std::vector<std::string> out;
+      split(c.text, c.pattern, std::back_inserter(out));
+      return out.size();
+    });
+  measure(c, "splitv-regex", [&] { return splitv(c.text, re).size(); });
+  measure(c, "tokenize", [&] { return tokenize(c.text, c.delims).size(); });
+  measure(c, "for_each_token", [&] {
+      std::size_t n = 0;
+      for_each_token(c.text, c.delims, [&](std::string_view) { n += 1; });
+      return n;
+    });
+  measure(c, "parallel_tokenize", [&] { return parallel_tokenize(c.text, c.delims).size(); });
+}
+
+int main(int argc, char **argv) {
+  std::size_t mb = argc > 1 ? std::atoi(argv[1]) : 1;
+  if (mb == 0)
+    mb = 1;
+
+  std::cout << "corpus,method,bytes,tokens,seconds,mb_per_s,ns_per_token,allocs_per_token\n";
+
+  mapped_file words("words.txt");
+  run({"words.txt", std::string(words.view()), " \t\n", "\\s+"});
+  for (int width : {4, 16, 64})
+    run(make_csv(mb << 20, width, 8));
+  run(make_log(mb << 20));
+
+  return 0;
+}
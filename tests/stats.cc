@@ -0,0 +1,59 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <random>
+#include <cmath>
+
+#include "useful/stats.hpp"
+
+using namespace useful;
+
+int main(void) {
+  std::vector<int> ints(1000);
+  for (int i = 0; i < 1000; i += 1)
+    ints[i] = i + 1;
+  auto s = summarize(ints);
+  std::cout << "1..1000: count " << s.count() << ", sum " << s.sum() << ", mean " << s.mean()
+            << ", variance " << s.variance() << " (should be 83333.25), min " << s.min()
+            << ", max " << s.max() << ", median about " << s.median() << '\n';
+
+  // Same values one at a time from a list
+  std::list<int> l(ints.begin(), ints.end());
+  auto s2 = summarize(l);
+  std::cout << "From a list: mean " << s2.mean() << ", variance " << s2.variance() << '\n';
+
+  // ints into a stats<double> go one at a time
+  stats<double> s3;
+  s3.add(ints.begin(), ints.end());
+  s3.add(ints.data(), ints.data() + 1);
+  std::cout << "As doubles, plus a second 1: count " << s3.count() << ", sum " << s3.sum()
+            << ", mean " << s3.mean() << '\n';
+
+  std::mt19937_64 rng(1);
+  std::normal_distribution<double> normal(100, 15);
+  std::vector<double> v(2000000);
+  for (auto &x : v)
+    x = normal(rng);
+
+  stats<double> a, b;
+  a.add(v.begin(), v.begin() + v.size() / 3);
+  b.add(v.begin() + v.size() / 3, v.end());
+  a.merge(b);
+  auto p = parallel_summarize(v);
+  std::cout << "\nNormal(100, 15), merged halves: mean " << a.mean() << ", stddev " << a.stddev()
+            << ", median about " << a.median() << '\n';
+  std::cout << "In parallel: mean " << p.mean() << ", stddev " << p.stddev() << '\n';
+  std::cout << "Quantiles:";
+  for (double q : {0.01, 0.25, 0.75, 0.99})
+    std::cout << ' ' << q << ": " << p.quantile(q) << " (expected " << 100 + 15 * (q < 0.5 ? -1 : 1) *
+      (q == 0.01 || q == 0.99 ? 2.326 : 0.674) << ')';
+  std::cout << '\n';
+
+  stats<float> empty;
+  try {
+    empty.median();
+  } catch (std::domain_error &e) {
+    std::cout << "\nMedian of nothing: " << e.what() << '\n';
+  }
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <type_traits>
+
+#include "useful/tokenize.hpp"
+#include "useful/string_pool.hpp"
+#include "useful/reader.hpp"
+
+using namespace useful;
+
+int main(void) {
+  mapped_file corpus("words.txt");
+
+  std::vector<std::string> copies;
+  std::size_t copybytes = 0;
+  string_pool pool;
+  std::vector<string_pool::handle> handles;
+  for_each_token(corpus.view(), " \t\n", [&](std::string_view w) {
+      copies.emplace_back(w);
+      copybytes += copies.back().capacity() + sizeof(std::string);
+      handles.push_back(pool.intern(w));
+    });
+
+  std::cout << copies.size() << " words, " << pool.size() << " distinct.\n"
+            << "As strings: " << copybytes << " bytes. Pooled: "
+            << pool.bytes() + handles.size() * sizeof(string_pool::handle)
+            << " bytes.\n";
+
+  bool same = true;
+  for (std::size_t n = 0; n < copies.size(); n += 1)
+    same &= pool[handles[n]] == copies[n];
+  std::cout << "Handles " << (same ? "match" : "DON'T MATCH") << " the words.\n";
+  std::cout << "\"curable\" has handle " << pool.find("curable")
+            << ", \"not-a-word\" has " << pool.find("not-a-word") << '\n';
+
+  // A moved-from pool is empty and still usable.
+  static_assert(std::is_nothrow_move_constructible<string_pool>::value, "string_pool move can throw");
+  string_pool moved(std::move(pool));
+  std::cout << "After a move, the new pool has " << moved.size() << " strings and the old one "
+            << pool.size() << '\n';
+  same &= moved[moved.find("curable")] == "curable" && pool.find("curable") == string_pool::npos
+    && pool[pool.intern("curable")] == "curable";
+  pool = std::move(moved);
+  moved.reserve(100);
+  same &= moved.intern("curable") == 0 && moved.size() == 1;
+
+  concurrent_string_pool cpool;
+  parallel_for_each_token(corpus.view(), " \t\n",
+                          [&](unsigned, std::string_view w) { cpool.intern(w); }, 4);
+  std::cout << "Interned on 4 threads: " << cpool.size() << " distinct, \"curable\" is "
+            << cpool[cpool.find("curable")] << '\n';
+
+  return same && cpool.size() == pool.size() ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <map>
 #include <vector>
@@ -8,17 +9,24 @@
 
 #include <useful/sort.hpp>
 #include <useful/range.hpp>
+#include <useful/reader.hpp>
 
 using namespace useful;
 
-using wcount = std::map<std::string, int>;
+using wcount = std::map<std::string, int, std::less<>>;
 
 int main(void) {
 	wcount words;
-	std::string word;
+	record_reader in(0);
+	std::string_view word;
 
-	while (std::cin >> word)
-		words[word] += 1;
+	while (in.next_word(word)) {
+		auto w = words.find(word);
+		if (w == words.end())
+			words.emplace(word, 1);
+		else
+			w->second += 1;
+	}
 	
 	std::vector<std::pair<std::string, int>> wordv(words.begin(), words.end());
 	std::partial_sort(wordv.begin(), wordv.begin() + 10, wordv.end(),
@@ -27,7 +35,7 @@ int main(void) {
 			//[](auto &a, auto &b) { return a.second > b.second; }			
 			);
 	
-	for (const auto p : take(wordv, 10))
+	for (const auto &p : take(wordv, 10))
 		std::cout << p.second << ": " << p.first << '\n';
 	
 	return 0;
@@ -0,0 +1,296 @@
+// End to end word counting over words.txt replicated to a large file,
+// timed per stage. Each mode runs in its own child process so peak RSS
+// is per mode. Modes:
+//
+//   baseline  ifstream into a string, operator>>, std::map, partial_sort
+//             of every distinct word (what wordcount.cc does)
+//   fast      mapped_file, for_each_token, flat_hash_map<string_view>,
+//             a k element heap
+//   parallel  mapped_file, parallel_for_each_token, a flat_hash_map per
+//             thread merged at the end, a k element heap
+//
+// Stages are read (bring the bytes into memory), tokenize (a pass that
+// only finds words), count (a full tokenize and count pass, since that is
+// how the pipeline runs; subtract the tokenize row for the counting cost
+// alone) and topk. gb_per_s is input bytes over stage time for every
+// stage, and peak_rss_mb is the process high water mark after the stage.
+// The generated file stays in the page cache, so read measures memory
+// bandwidth rather than the disk. The result column of topk is the top
+// word and its count, which should agree across modes.
+//
+// Prints CSV: mode,stage,bytes,seconds,gb_per_s,peak_rss_mb,result
+//
+// Usage: wordcount_bench [size in MB, default 256]
+//                        [baseline|fast|parallel|all, default all]
+//                        [corpus file, default /tmp/wordcount_bench.txt]
+//                        [threads, default default_threads()]
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "useful/bench.hpp"
+#include "useful/flat_hash_map.hpp"
+#include "useful/reader.hpp"
+#include "useful/thread.hpp"
+#include "useful/tokenize.hpp"
+
+using namespace useful;
+
+namespace {
+  constexpr std::string_view delims = " \t\n\r\v\f";
+  constexpr std::size_t top_k = 10;
+
+  using count_pair = std::pair<std::string_view, std::uint64_t>;
+  using count_map = flat_hash_map<std::string_view, std::uint64_t>;
+
+  // A per thread counter on its own cache line.
+  struct alignas(64) padded_count {
+    std::uint64_t n = 0;
+  };
+
+  // Highest count first, ties broken by word so every mode agrees.
+  struct by_count {
+    template<class P, class Q>
+    bool operator()(const P &a, const Q &b) const {
+      if (a.second != b.second)
+        return a.second > b.second;
+      return a.first < b.first;
+    }
+  };
+
+  class stage_timer {
+  private:
+    using clock = std::chrono::steady_clock;
+    const char *mode;
+    std::uint64_t bytes;
+    clock::time_point start;
+
+  public:
+    stage_timer(const char *mode_, std::uint64_t bytes_)
+      : mode(mode_), bytes(bytes_), start(clock::now()) {}
+
+    void done(const char *stage, const std::string &result = "") {
+      std::chrono::duration<double> secs = clock::now() - start;
+      struct rusage ru;
+      getrusage(RUSAGE_SELF, &ru);
+      std::cout << mode << ',' << stage << ',' << bytes << ',' << secs.count() << ','
+                << bytes / secs.count() / 1e9 << ',' << ru.ru_maxrss / 1024 << ','
+                << result << std::endl;
+      start = clock::now();
+    }
+  };
+
+  template<class P>
+  std::string describe(const std::vector<P> &top) {
+    if (top.empty())
+      return "";
+    std::ostringstream out;
+    out << top.front().first << ':' << top.front().second;
+    return out.str();
+  }
+
+  // The k most common words of m, using a heap of k elements.
+  template<class Map>
+  std::vector<count_pair> select_top(const Map &m, std::size_t k) {
+    std::vector<count_pair> heap;
+    heap.reserve(k + 1);
+    by_count cmp;
+    for (const auto &kv : m) {
+      if (heap.size() == k && !cmp(kv, heap.front()))
+        continue;
+      heap.emplace_back(kv.first, kv.second);
+      std::push_heap(heap.begin(), heap.end(), cmp);
+      if (heap.size() > k) {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        heap.pop_back();
+      }
+    }
+    std::sort_heap(heap.begin(), heap.end(), cmp);
+    return heap;
+  }
+
+  // Touches every page of s so the read stage pays for the page faults.
+  std::uint64_t touch(std::string_view s) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < s.size(); i += 4096)
+      sum += static_cast<unsigned char>(s[i]);
+    return sum;
+  }
+
+  void run_baseline(const std::string &path, std::uint64_t bytes) {
+    stage_timer t("baseline", bytes);
+
+    std::string text;
+    {
+      std::ifstream in(path, std::ios::binary);
+      std::ostringstream buf;
+      buf << in.rdbuf();
+      text = std::move(buf).str();
+    }
+    t.done("read");
+
+    std::uint64_t tokens = 0;
+    {
+      std::istringstream in(text);
+      std::string word;
+      while (in >> word)
+        tokens += 1;
+    }
+    t.done("tokenize", std::to_string(tokens));
+
+    std::map<std::string, std::uint64_t> words;
+    {
+      std::istringstream in(text);
+      std::string word;
+      while (in >> word)
+        words[word] += 1;
+    }
+    t.done("count", std::to_string(words.size()));
+
+    std::vector<std::pair<std::string, std::uint64_t>> all(words.begin(), words.end());
+    std::partial_sort(all.begin(), all.begin() + std::min(top_k, all.size()), all.end(),
+                      by_count());
+    all.resize(std::min(top_k, all.size()));
+    t.done("topk", describe(all));
+  }
+
+  void run_fast(const std::string &path, std::uint64_t bytes) {
+    stage_timer t("fast", bytes);
+
+    mapped_file file(path);
+    std::string_view text = file.view();
+    do_not_optimize(touch(text));
+    t.done("read");
+
+    std::uint64_t tokens = 0;
+    for_each_token(text, delims, [&](std::string_view) { tokens += 1; });
+    t.done("tokenize", std::to_string(tokens));
+
+    count_map words;
+    for_each_token(text, delims, [&](std::string_view w) { words[w] += 1; });
+    t.done("count", std::to_string(words.size()));
+
+    t.done("topk", describe(select_top(words, top_k)));
+  }
+
+  void run_parallel(const std::string &path, std::uint64_t bytes, unsigned threads) {
+    stage_timer t("parallel", bytes);
+
+    mapped_file file(path);
+    std::string_view text = file.view();
+    auto chunks = token_chunks(text, delims, threads);
+    std::vector<std::uint64_t> sums(threads);
+    run_threads(threads, [&](unsigned i) { sums[i] = touch(chunks[i]); });
+    do_not_optimize(sums);
+    t.done("read");
+
+    std::vector<padded_count> tokens(threads);
+    parallel_for_each_token(text, delims,
+                            [&](unsigned i, std::string_view) { tokens[i].n += 1; },
+                            threads);
+    std::uint64_t total = 0;
+    for (const auto &c : tokens)
+      total += c.n;
+    t.done("tokenize", std::to_string(total));
+
+    std::vector<count_map> parts(threads);
+    parallel_for_each_token(text, delims,
+                            [&](unsigned i, std::string_view w) { parts[i][w] += 1; },
+                            threads);
+    count_map &words = parts[0];
+    for (unsigned i = 1; i < threads; i += 1) {
+      for (const auto &kv : parts[i])
+        words[kv.first] += kv.second;
+      count_map().swap(parts[i]);
+    }
+    t.done("count", std::to_string(words.size()));
+
+    t.done("topk", describe(select_top(words, top_k)));
+  }
+
+  // Writes words.txt repeatedly to path until it is at least mb megabytes,
+  // unless it is already that big.
+  std::uint64_t make_corpus(const std::string &path, std::uint64_t mb) {
+    std::uint64_t want = mb << 20;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && static_cast<std::uint64_t>(st.st_size) >= want &&
+        static_cast<std::uint64_t>(st.st_size) < want + (1 << 20))
+      return st.st_size;
+
+    mapped_file words("words.txt");
+    std::string block;
+    while (block.size() < (1 << 20)) {
+      block.append(words.view());
+      block.push_back('\n');
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::uint64_t written = 0;
+    while (written < want) {
+      out.write(block.data(), block.size());
+      written += block.size();
+    }
+    out.close();
+    if (!out) {
+      std::cerr << "wordcount_bench: can't write " << path << '\n';
+      std::exit(EXIT_FAILURE);
+    }
+    return written;
+  }
+}
+
+int main(int argc, char **argv) {
+  std::uint64_t mb = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+  std::string mode = argc > 2 ? argv[2] : "all";
+  std::string path = argc > 3 ? argv[3] : "/tmp/wordcount_bench.txt";
+  unsigned threads = argc > 4 ? std::atoi(argv[4]) : 0;
+  if (threads == 0)
+    threads = default_threads();
+  if (mb == 0 || (mode != "all" && mode != "baseline" && mode != "fast" &&
+                  mode != "parallel")) {
+    std::cerr << "Usage: wordcount_bench [MB] [baseline|fast|parallel|all] [file] [threads]\n";
+    return EXIT_FAILURE;
+  }
+
+  std::uint64_t bytes = make_corpus(path, mb);
+
+  std::cout << "mode,stage,bytes,seconds,gb_per_s,peak_rss_mb,result" << std::endl;
+  std::vector<std::function<void()>> runs;
+  if (mode == "all" || mode == "baseline")
+    runs.emplace_back([&] { run_baseline(path, bytes); });
+  if (mode == "all" || mode == "fast")
+    runs.emplace_back([&] { run_fast(path, bytes); });
+  if (mode == "all" || mode == "parallel")
+    runs.emplace_back([&] { run_parallel(path, bytes, threads); });
+
+  int status = EXIT_SUCCESS;
+  for (auto &run : runs) {
+    pid_t pid = fork();
+    if (pid < 0) {
+      std::perror("fork");
+      return EXIT_FAILURE;
+    }
+    if (pid == 0) {
+      run();
+      std::_Exit(EXIT_SUCCESS);
+    }
+    int ws;
+    if (waitpid(pid, &ws, 0) < 0 || !WIFEXITED(ws) || WEXITSTATUS(ws) != 0)
+      status = EXIT_FAILURE;
+  }
+  return status;
+}
@@ -0,0 +1,264 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 shawnw
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef USEFUL_ARENA_HPP
+#define USEFUL_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+/* Arenas for short-lived allocations. Memory is carved out of a few
+ * large blocks instead of going to the global heap for each object, and
+ * everything is given back at once with reset(), which keeps the blocks
+ * for the next round. Arenas aren't thread safe; give each thread its
+ * own (see thread_arena()).
+ *
+ * | monotonic_arena arena;
+ * | std::vector<int, arena_allocator<int>> v(arena_allocator<int>(arena));
+ * | ...
+ * | arena.reset(); // After v is gone
+ */
+
+namespace useful {
+
+  /* A bump pointer arena. Allocating is a pointer increment, and
+   * deallocating does nothing; the memory is only reclaimed by reset()
+   * or release(). Blocks double in size as more are needed, and after
+   * a reset that found more than one block in use, they're replaced with
+   * one block big enough for all of it, so a steady workload settles
+   * down to a single block and no heap calls at all.
+   */
+  class monotonic_arena {
+  public:
+    static constexpr std::size_t default_block_size = 64 * 1024;
+    static constexpr std::size_t max_block_size = std::size_t(1) << 26;
+
+  private:
+    struct block {
+      char *data;
+      std::size_t size;
+    };
+    std::vector<block> blocks;
+    char *next = nullptr;
+    std::size_t left = 0;
+    std::size_t block_size;
+    std::size_t used = 0;
+
+    void add_block(std::size_t min_size) {
+      std::size_t size = std::max(block_size, min_size);
+      blocks.reserve(blocks.size() + 1);
+      next = static_cast<char *>(::operator new(size));
+      blocks.push_back(block{next, size});
+      left = size;
+      block_size = std::min(block_size * 2, std::max(max_block_size, block_size));
+    }
+
+    void free_blocks() noexcept {
+      for (auto &b : blocks)
+        ::operator delete(b.data);
+      blocks.clear();
+      next = nullptr;
+      left = 0;
+    }
+
+  public:
+    explicit monotonic_arena(std::size_t block_size_ = default_block_size)
+      : block_size(std::max<std::size_t>(block_size_, 64)) {}
+    monotonic_arena(const monotonic_arena &) = delete;
+    monotonic_arena &operator=(const monotonic_arena &) = delete;
+    ~monotonic_arena() { free_blocks(); }
+
+    /* Returns bytes of memory aligned to align, which must be a power of
+     * two. Throws std::bad_alloc if the heap is exhausted. */
+    void *allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+      std::size_t pad = -reinterpret_cast<std::uintptr_t>(next) & (align - 1);
+      if (pad + bytes > left) {
+        add_block(bytes + align);
+        pad = -reinterpret_cast<std::uintptr_t>(next) & (align - 1);
+      }
+      char *p = next + pad;
+      next = p + bytes;
+      left -= pad + bytes;
+      used += pad + bytes;
+      return p;
+    }
+
+    void deallocate(void *, std::size_t, std::size_t = alignof(std::max_align_t)) noexcept {}
+
+    /* Frees everything allocated from the arena at once, keeping the
+     * memory for reuse. */
+    void reset() {
+      if (blocks.size() > 1) {
+        std::size_t total = 0;
+        for (auto &b : blocks)
+          total += b.size;
+        free_blocks();
+        block_size = std::min(total, std::max(max_block_size, block_size));
+        add_block(total);
+      } else if (!blocks.empty()) {
+        next = blocks[0].data;
+        left = blocks[0].size;
+      }
+      used = 0;
+    }
+
+    /* Frees everything and returns the memory to the heap too. */
+    void release() noexcept {
+      free_blocks();
+      used = 0;
+    }
+
+    // Bytes handed out (including alignment padding) since the last reset
+    std::size_t bytes_used() const noexcept { return used; }
+    // Bytes of blocks held
+    std::size_t capacity() const noexcept {
+      std::size_t total = 0;
+      for (auto &b : blocks)
+        total += b.size;
+      return total;
+    }
+  };
+
+  /* An arena with free lists for power of two size classes from 8 bytes
+   * to max_pooled, so memory that's deallocated is reused by later
+   * allocations of a similar size, on top of a monotonic_arena. Suits
+   * node-based containers that churn. Bigger requests come straight from
+   * the monotonic arena and aren't reused until reset().
+   */
+  class pool_arena {
+  public:
+    static constexpr std::size_t max_pooled = 4096;
+
+  private:
+    static constexpr std::size_t min_shift = 3;
+    static constexpr std::size_t classes = 10; // 8 bytes to 4K
+    struct free_node {
+      free_node *next;
+    };
+    monotonic_arena arena;
+    free_node *free_lists[classes] = {};
+
+    static std::size_t size_class(std::size_t bytes) noexcept {
+      std::size_t c = 0;
+      while ((std::size_t(1) << (c + min_shift)) < bytes)
+        c += 1;
+      return c;
+    }
+
+  public:
+    explicit pool_arena(std::size_t block_size = monotonic_arena::default_block_size)
+      : arena(block_size) {}
+
+    void *allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+      if (bytes > max_pooled || align > alignof(std::max_align_t))
+        return arena.allocate(bytes, align);
+      // Each class is aligned to its size, up to max_align_t
+      std::size_t c = size_class(std::max(bytes, align));
+      if (free_node *n = free_lists[c]) {
+        free_lists[c] = n->next;
+        return n;
+      }
+      std::size_t size = std::size_t(1) << (c + min_shift);
+      return arena.allocate(size, std::min(size, alignof(std::max_align_t)));
+    }
+
+    void deallocate(void *p, std::size_t bytes, std::size_t align = alignof(std::max_align_t)) noexcept {
+      if (bytes > max_pooled || align > alignof(std::max_align_t))
+        return;
+      std::size_t c = size_class(std::max(bytes, align));
+      free_lists[c] = ::new (p) free_node{free_lists[c]};
+    }
+
+    void reset() {
+      std::fill(std::begin(free_lists), std::end(free_lists), nullptr);
+      arena.reset();
+    }
+
+    void release() noexcept {
+      std::fill(std::begin(free_lists), std::end(free_lists), nullptr);
+      arena.release();
+    }
+
+    std::size_t capacity() const noexcept { return arena.capacity(); }
+  };
+
+  /* A standard allocator that gets its memory from an arena, for use
+   * with containers, strings, and the allocator-aware overloads in
+   * string.hpp, combos.hpp and sort.hpp. Copies share the arena, which
+   * must outlive everything allocated from it.
+   */
+  template<class T, class Arena = monotonic_arena>
+  class arena_allocator {
+  public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    template<class U>
+    struct rebind {
+      using other = arena_allocator<U, Arena>;
+    };
+
+  private:
+    Arena *a;
+    template<class U, class A> friend class arena_allocator;
+
+  public:
+    explicit arena_allocator(Arena &a_) noexcept : a(&a_) {}
+    template<class U>
+    arena_allocator(const arena_allocator<U, Arena> &other) noexcept : a(other.a) {}
+
+    T *allocate(std::size_t n) {
+      if (n > std::size_t(-1) / sizeof(T))
+        throw std::bad_alloc();
+      return static_cast<T *>(a->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+      a->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    Arena &arena() const noexcept { return *a; }
+
+    template<class U>
+    bool operator==(const arena_allocator<U, Arena> &other) const noexcept { return a == other.a; }
+    template<class U>
+    bool operator!=(const arena_allocator<U, Arena> &other) const noexcept { return a != other.a; }
+  };
+
+  /* A monotonic arena for the calling thread, for per-request scratch
+   * space. Reset it when the request is done. */
+  inline monotonic_arena &thread_arena() {
+    thread_local monotonic_arena arena;
+    return arena;
+  }
+};
+
+#endif
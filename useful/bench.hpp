@@ -0,0 +1,333 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 shawnw
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef USEFUL_BENCH_HPP
+#define USEFUL_BENCH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <type_traits>
+#include <atomic>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/* A small microbenchmark harness.
+ *
+ * | benchmark b;
+ * | b.run("sum", [&] { return sum(v); }, v.size() * sizeof(double));
+ *
+ * Each run warms up, picks an iteration count so a sample takes long
+ * enough to time reliably, then takes a number of samples and prints a
+ * CSV row with the median time per iteration, its median absolute
+ * deviation, percentiles, throughput, and (on Linux, when the kernel
+ * allows it) cycles, instructions, cache misses and branch misses per
+ * iteration from perf_event_open. Build benchmarks with optimization.
+ */
+
+namespace useful {
+
+#if defined(__GNUC__)
+  /* Makes the compiler assume value is used, so the computation of it
+   * isn't optimized away, without generating any code. */
+  template<class T>
+  inline void do_not_optimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  template<class T>
+  inline void do_not_optimize(T &value) {
+    asm volatile("" : "+r,m"(value) : : "memory");
+  }
+
+  /* Makes the compiler assume all memory was read and written, so
+   * stores before it aren't optimized away. */
+  inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+  }
+#else
+  namespace detail {
+    inline volatile const void *bench_sink;
+  };
+
+  template<class T>
+  inline void do_not_optimize(const T &value) {
+    detail::bench_sink = &value;
+  }
+
+  inline void clobber_memory() {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  }
+#endif
+
+  /* Hardware counters for the calling thread: cycles, instructions,
+   * cache misses and branch misses, counted in user space only. If the
+   * kernel doesn't allow it (see /proc/sys/kernel/perf_event_paranoid),
+   * or this isn't Linux, available() is false and the counts are 0. */
+  class perf_counters {
+  public:
+    static constexpr int events = 4;
+    struct values {
+      std::uint64_t cycles = 0, instructions = 0, cache_misses = 0, branch_misses = 0;
+    };
+
+  private:
+    int fds[events] = {-1, -1, -1, -1};
+    bool ok = false;
+
+  public:
+    perf_counters() {
+#ifdef __linux__
+      const std::uint64_t configs[events] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+      };
+      for (int i = 0; i < events; i += 1) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof attr;
+        attr.config = configs[i];
+        attr.disabled = i == 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0);
+        if (fds[i] < 0) {
+          close_all();
+          return;
+        }
+      }
+      ok = true;
+#endif
+    }
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+    ~perf_counters() { close_all(); }
+
+    bool available() const noexcept { return ok; }
+
+    void start() noexcept {
+#ifdef __linux__
+      if (ok) {
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      }
+#endif
+    }
+
+    values stop() noexcept {
+      values v;
+#ifdef __linux__
+      if (ok) {
+        ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        std::uint64_t buf[1 + events];
+        if (read(fds[0], buf, sizeof buf) == static_cast<ssize_t>(sizeof buf) && buf[0] == events) {
+          v.cycles = buf[1];
+          v.instructions = buf[2];
+          v.cache_misses = buf[3];
+          v.branch_misses = buf[4];
+        }
+      }
+#endif
+      return v;
+    }
+
+  private:
+    void close_all() noexcept {
+#ifdef __linux__
+      for (auto &fd : fds) {
+        if (fd >= 0)
+          close(fd);
+        fd = -1;
+      }
+#endif
+      ok = false;
+    }
+  };
+
+  struct bench_options {
+    // Time spent running the benchmark before measuring it
+    double warmup_seconds = 0.05;
+    // Each sample runs enough iterations to take at least this long
+    double sample_seconds = 0.01;
+    int samples = 15;
+  };
+
+  struct bench_result {
+    std::string name;
+    std::uint64_t iterations = 0; // Per sample
+    std::vector<double> ns;       // Per iteration, for each sample, sorted
+    double median = 0, mad = 0, min = 0, p90 = 0, p99 = 0, max = 0;
+    double bytes = 0, items = 0;  // Per iteration, if given
+    bool have_counters = false;
+    // Per iteration, averaged over all samples
+    double cycles = 0, instructions = 0, cache_misses = 0, branch_misses = 0;
+
+    double gb_per_second() const { return bytes > 0 ? bytes / median : 0; }
+    double items_per_second() const { return items > 0 ? items / median * 1e9 : 0; }
+  };
+
+  namespace detail {
+    // The p'th percentile of sorted values, interpolating between them
+    inline double percentile(const std::vector<double> &sorted, double p) {
+      if (sorted.empty())
+        return 0;
+      double pos = p / 100 * (sorted.size() - 1);
+      std::size_t i = pos;
+      if (i + 1 >= sorted.size())
+        return sorted.back();
+      return sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]);
+    }
+
+    template<class Function>
+    double time_iterations(Function &f, std::uint64_t n) {
+      using clock = std::chrono::steady_clock;
+      auto start = clock::now();
+      for (std::uint64_t i = 0; i < n; i += 1) {
+        if constexpr (std::is_void<decltype(f())>::value)
+          f();
+        else
+          do_not_optimize(f());
+      }
+      std::chrono::duration<double> secs = clock::now() - start;
+      return secs.count();
+    }
+  };
+
+  /* Runs benchmarks and prints a CSV row for each to a stream:
+   * name,iterations,median_ns,mad_ns,min_ns,p90_ns,p99_ns,max_ns,gb_per_s,
+   * items_per_s,cycles,instructions,ipc,cache_misses,branch_misses
+   * The counter columns are per iteration, and empty if unavailable. */
+  class benchmark {
+  private:
+    std::ostream &out;
+    bench_options opt;
+    perf_counters counters;
+    bool printed_header = false;
+    std::vector<bench_result> all;
+
+  public:
+    explicit benchmark(std::ostream &out_ = std::cout, bench_options opt_ = bench_options())
+      : out(out_), opt(opt_) {}
+
+    const bench_options &options() const noexcept { return opt; }
+    bool have_counters() const noexcept { return counters.available(); }
+    const std::vector<bench_result> &results() const noexcept { return all; }
+
+    /* Times f(). bytes and items are how much one call processes, for
+     * the throughput columns. If f returns a value, it's passed to
+     * do_not_optimize(). Returns a copy of the result, which is also
+     * kept in results(). */
+    template<class Function>
+    bench_result run(const std::string &name, Function f, double bytes = 0, double items = 0) {
+      bench_result r;
+      r.name = name;
+      r.bytes = bytes;
+      r.items = items;
+
+      double spent = 0;
+      do
+        spent += detail::time_iterations(f, 1);
+      while (spent < opt.warmup_seconds);
+
+      // Grow the iteration count until a sample is long enough
+      std::uint64_t n = 1;
+      for (;;) {
+        double t = detail::time_iterations(f, n);
+        if (t >= opt.sample_seconds)
+          break;
+        double grow = t > 0 ? opt.sample_seconds / t * 1.2 : 10;
+        n = std::max<std::uint64_t>(n + 1, n * std::min(grow, 10.0));
+      }
+      r.iterations = n;
+
+      perf_counters::values total;
+      for (int s = 0; s < opt.samples; s += 1) {
+        counters.start();
+        double t = detail::time_iterations(f, n);
+        auto v = counters.stop();
+        total.cycles += v.cycles;
+        total.instructions += v.instructions;
+        total.cache_misses += v.cache_misses;
+        total.branch_misses += v.branch_misses;
+        r.ns.push_back(t * 1e9 / n);
+      }
+      std::sort(r.ns.begin(), r.ns.end());
+      r.median = detail::percentile(r.ns, 50);
+      r.min = r.ns.front();
+      r.max = r.ns.back();
+      r.p90 = detail::percentile(r.ns, 90);
+      r.p99 = detail::percentile(r.ns, 99);
+      std::vector<double> dev;
+      for (double x : r.ns)
+        dev.push_back(std::fabs(x - r.median));
+      std::sort(dev.begin(), dev.end());
+      r.mad = detail::percentile(dev, 50);
+
+      r.have_counters = counters.available();
+      double iters = double(n) * opt.samples;
+      r.cycles = total.cycles / iters;
+      r.instructions = total.instructions / iters;
+      r.cache_misses = total.cache_misses / iters;
+      r.branch_misses = total.branch_misses / iters;
+
+      print(r);
+      all.push_back(r);
+      return r;
+    }
+
+  private:
+    void print(const bench_result &r) {
+      if (!printed_header) {
+        out << "name,iterations,median_ns,mad_ns,min_ns,p90_ns,p99_ns,max_ns,gb_per_s,items_per_s,"
+          "cycles,instructions,ipc,cache_misses,branch_misses\n";
+        printed_header = true;
+      }
+      out << r.name << ',' << r.iterations << ',' << r.median << ',' << r.mad << ',' << r.min << ','
+          << r.p90 << ',' << r.p99 << ',' << r.max << ',' << r.gb_per_second() << ','
+          << r.items_per_second() << ',';
+      if (r.have_counters)
+        out << r.cycles << ',' << r.instructions << ','
+            << (r.cycles > 0 ? r.instructions / r.cycles : 0) << ','
+            << r.cache_misses << ',' << r.branch_misses;
+      else
+        out << ",,,,";
+      out << '\n' << std::flush;
+    }
+  };
+};
+
+#endif
@@ -22,21 +22,502 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#ifndef USEFUL_COMBOS_HPP
+#define USEFUL_COMBOS_HPP
+
 #include <vector>
+#include <memory>
+#include <iterator>
+#include <stdexcept>
+#include <numeric>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 
 #include "useful/math.hpp"
+#include "useful/thread.hpp"
 
 namespace useful {
-	/* Return the number of combinations of r items of a set of n items */
-	constexpr int ncr(int n, int r) {
-		return factorial(n) / (factorial(r) * factorial(n - r));
+	namespace detail {
+		template<std::uint64_t... V>
+		struct pascal_values {
+			static constexpr std::uint64_t v[sizeof...(V)] = {V...};
+		};
+		template<std::uint64_t... V>
+		constexpr std::uint64_t pascal_values<V...>::v[sizeof...(V)];
+
+		template<class A, class B> struct add_pascal_values;
+		template<std::uint64_t... A, std::uint64_t... B>
+		struct add_pascal_values<pascal_values<A...>, pascal_values<B...>> {
+			using type = pascal_values<(A + B)...>;
+		};
+
+		// Row n of Pascal's triangle, built at compile time by adding row
+		// n - 1 to itself shifted over by one
+		template<std::size_t N>
+		struct pascal_row {
+			template<class R> struct next;
+			template<std::uint64_t... V>
+			struct next<pascal_values<V...>> {
+				using type = typename add_pascal_values<pascal_values<0, V...>, pascal_values<V..., 0>>::type;
+			};
+			using type = typename next<typename pascal_row<N - 1>::type>::type;
+		};
+		template<>
+		struct pascal_row<0> { using type = pascal_values<1>; };
+
+		template<std::size_t... I> struct index_list {};
+		template<class L> struct extend_index_list;
+		template<std::size_t... I>
+		struct extend_index_list<index_list<I...>> { using type = index_list<I..., sizeof...(I)>; };
+		// index_list<0, 1, ..., N - 1>
+		template<std::size_t N>
+		struct make_index_list {
+			using type = typename extend_index_list<typename make_index_list<N - 1>::type>::type;
+		};
+		template<>
+		struct make_index_list<0> { using type = index_list<>; };
+
+		// Pascal's triangle through row 67, the last one whose entries
+		// all fit in 64 bits.
+		template<class = typename make_index_list<68>::type>
+		struct pascal_triangle;
+		template<std::size_t... N>
+		struct pascal_triangle<index_list<N...>> {
+			static constexpr std::size_t rows = sizeof...(N);
+			static constexpr const std::uint64_t *row[rows] = { pascal_row<N>::type::v... };
+		};
+		template<std::size_t... N>
+		constexpr std::size_t pascal_triangle<index_list<N...>>::rows;
+		template<std::size_t... N>
+		constexpr const std::uint64_t *pascal_triangle<index_list<N...>>::row[];
+
+		constexpr std::size_t pascal_rows = pascal_triangle<>::rows;
+
+		constexpr std::uint64_t binomials(std::size_t n, std::size_t k) {
+			return pascal_triangle<>::row[n][k];
+		}
+
+		// std::gcd() only takes types that std::is_integral knows about
+		template<typename T>
+		constexpr T gcd(T a, T b) {
+			return b == 0 ? a : gcd<T>(b, a % b);
+		}
+
+		// One step of the multiplicative formula: given c = C(m - 1, i - 1),
+		// returns C(m, i), dividing out common factors first so no
+		// intermediate value exceeds the result.
+		template<typename T>
+		constexpr T binomial_step(T c, T g, std::uint64_t m, std::uint64_t i, std::false_type) {
+			return c / g * (static_cast<T>(m) / static_cast<T>(i / g));
+		}
+		template<typename T>
+		constexpr T binomial_step(T c, T g, std::uint64_t m, std::uint64_t i, std::true_type) {
+			return checked_multiply<T>(c / g, static_cast<T>(m) / static_cast<T>(i / g), "ncr");
+		}
+
+		template<typename T, bool Checked>
+		constexpr T binomial_from(std::uint64_t n, std::uint64_t r, std::uint64_t i, T c) {
+			return i > r ? c
+				: binomial_from<T, Checked>(n, r, i + 1,
+				                            binomial_step<T>(c, gcd<T>(c, i), n - r + i, i,
+				                                             std::integral_constant<bool, Checked>()));
+		}
+
+		// The multiplicative formula for C(n, r), with r <= n
+		template<typename T, bool Checked>
+		constexpr T binomial(std::uint64_t n, std::uint64_t r) {
+			return binomial_from<T, Checked>(n, r > n - r ? n - r : r, 1, T(1));
+		}
+
+		// The checked functions do their arithmetic in 64 bits unless T
+		// is wider, and range check the result before converting it.
+		template<typename T>
+		using checked_type = typename std::conditional<(sizeof(T) > sizeof(std::uint64_t)),
+		                                               T, std::uint64_t>::type;
+
+		template<typename T, typename U>
+		constexpr T narrow_checked(U v, const char *what) {
+			return v > static_cast<U>(max_value<T>()) ? throw std::overflow_error{what} : static_cast<T>(v);
+		}
+	};
+
+	/* Return the number of combinations of r items of a set of n items.
+	 * O(1) from a table for 64 bit or smaller results with n < 68, and
+	 * exact for any result that fits in T otherwise; use
+	 * ncr<unsigned __int128> for bigger ones. Silently overflows if the
+	 * result doesn't fit; see ncr_checked(). */
+	template<typename T = std::uint64_t>
+	constexpr T ncr(std::uint64_t n, std::uint64_t r) {
+		return r > n ? T(0)
+			: sizeof(T) <= sizeof(std::uint64_t) && n < detail::pascal_rows
+			? static_cast<T>(detail::binomials(n, r))
+			: detail::binomial<T, false>(n, r);
+	}
+
+	/* Like ncr(), but throws std::overflow_error if the result doesn't fit in T. */
+	template<typename T = std::uint64_t>
+	constexpr T ncr_checked(std::uint64_t n, std::uint64_t r) {
+		using U = detail::checked_type<T>;
+		return r > n ? T(0)
+			: detail::narrow_checked<T>(n < detail::pascal_rows ? static_cast<U>(detail::binomials(n, r))
+			                            : detail::binomial<U, true>(n, r), "ncr");
+	}
+
+	/* Return the number of permutations of r items of a set of n items.
+	 * O(1) from the factorial table for n <= 20. Silently overflows if
+	 * the result doesn't fit; see npr_checked(). */
+	template<typename T = std::uint64_t>
+	constexpr T npr(std::uint64_t n, std::uint64_t r) {
+		return r > n ? T(0)
+			: n < detail::factorials::size
+			? static_cast<T>(detail::factorials::v[n] / detail::factorials::v[n - r])
+			: detail::product_of_range(static_cast<T>(n - r + 1), r);
 	}
 
-	/* Return the number of permutations of r items of a set of n items */
-	constexpr int npr(int n, int r) {
-		return factorial(n) / factorial(n - r);
+	/* Like npr(), but throws std::overflow_error if the result doesn't fit in T. */
+	template<typename T = std::uint64_t>
+	constexpr T npr_checked(std::uint64_t n, std::uint64_t r) {
+		using U = detail::checked_type<T>;
+		return r > n ? T(0)
+			: detail::narrow_checked<T>(detail::checked_product_of_range<U>(n - r + 1, n, 1, "npr"), "npr");
 	}
 
+	/* Natural logarithms of ncr() and npr(), for sizes beyond any integer type. */
+	inline double log_ncr(double n, double r) {
+		return log_factorial(n) - log_factorial(r) - log_factorial(n - r);
+	}
+
+	inline double log_npr(double n, double r) {
+		return log_factorial(n) - log_factorial(n - r);
+	}
+
+	/* The combinatorial number system: maps each combination of r out of
+	 * n positions, as an increasing array of indexes, to its rank in
+	 * lexicographic order, 0 through C(n, r) - 1, and back. Lets
+	 * enumeration start anywhere, so it can be split up or resumed.
+	 */
+	inline std::uint64_t combination_rank(std::size_t n, const std::size_t *idx, std::size_t r) {
+		// Ranking the complement in reverse colex order is a sum of r terms.
+		std::uint64_t sum = 0;
+		for (std::size_t i = 0; i < r; i += 1)
+			sum += ncr(n - 1 - idx[i], r - i);
+		return ncr(n, r) - 1 - sum;
+	}
+
+	inline std::vector<std::size_t> combination_unrank(std::size_t n, std::size_t r, std::uint64_t k) {
+		if (k >= ncr(n, r))
+			throw std::out_of_range{"combination rank"};
+		std::vector<std::size_t> idx(r);
+		std::size_t c = 0;
+		for (std::size_t i = 0; i < r; i += 1, c += 1) {
+			// Skip over all the combinations that have c at position i
+			while (true) {
+				std::uint64_t with_c = ncr(n - 1 - c, r - 1 - i);
+				if (k < with_c)
+					break;
+				k -= with_c;
+				c += 1;
+			}
+			idx[i] = c;
+		}
+		return idx;
+	}
+
+	/* A read-only view of the elements of a vector picked out by an
+	 * array of indexes. This is what the lazy combination ranges yield;
+	 * it's only valid until the iterator it came from advances. Use
+	 * to_vector() to keep a copy.
+	 */
+	template<typename N>
+	class index_view {
+	public:
+		using value_type = N;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using const_reference = const N &;
+
+		class const_iterator {
+		private:
+			const std::vector<N> *items = nullptr;
+			const std::size_t *i = nullptr;
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = N;
+			using difference_type = std::ptrdiff_t;
+			using reference = const N &;
+			using pointer = const N *;
+
+			const_iterator() = default;
+			const_iterator(const std::vector<N> *items_, const std::size_t *i_)
+				: items(items_), i(i_) {}
+
+			reference operator*() const { return (*items)[*i]; }
+			pointer operator->() const { return &(*items)[*i]; }
+			reference operator[](difference_type n) const { return (*items)[i[n]]; }
+			const_iterator &operator++() { ++i; return *this; }
+			const_iterator operator++(int) { auto t = *this; ++i; return t; }
+			const_iterator &operator--() { --i; return *this; }
+			const_iterator operator--(int) { auto t = *this; --i; return t; }
+			const_iterator &operator+=(difference_type n) { i += n; return *this; }
+			const_iterator &operator-=(difference_type n) { i -= n; return *this; }
+			friend const_iterator operator+(const_iterator a, difference_type n) { return a += n; }
+			friend const_iterator operator+(difference_type n, const_iterator a) { return a += n; }
+			friend const_iterator operator-(const_iterator a, difference_type n) { return a -= n; }
+			friend difference_type operator-(const const_iterator &a, const const_iterator &b) {
+				return a.i - b.i;
+			}
+			friend bool operator==(const const_iterator &a, const const_iterator &b) { return a.i == b.i; }
+			friend bool operator!=(const const_iterator &a, const const_iterator &b) { return a.i != b.i; }
+			friend bool operator<(const const_iterator &a, const const_iterator &b) { return a.i < b.i; }
+			friend bool operator>(const const_iterator &a, const const_iterator &b) { return a.i > b.i; }
+			friend bool operator<=(const const_iterator &a, const const_iterator &b) { return a.i <= b.i; }
+			friend bool operator>=(const const_iterator &a, const const_iterator &b) { return a.i >= b.i; }
+		};
+		using iterator = const_iterator;
+
+	private:
+		const std::vector<N> *items;
+		const std::size_t *idx;
+		std::size_t r;
+
+	public:
+		index_view(const std::vector<N> &items_, const std::size_t *idx_, std::size_t r_)
+			: items(&items_), idx(idx_), r(r_) {}
+
+		size_type size() const noexcept { return r; }
+		bool empty() const noexcept { return r == 0; }
+		const N &operator[](size_type n) const { return (*items)[idx[n]]; }
+		const N &front() const { return (*items)[idx[0]]; }
+		const N &back() const { return (*items)[idx[r - 1]]; }
+
+		// The positions in the source vector of the elements
+		const std::size_t *indexes() const noexcept { return idx; }
+
+		const_iterator begin() const noexcept { return const_iterator(items, idx); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator end() const noexcept { return const_iterator(items, idx + r); }
+		const_iterator cend() const noexcept { return end(); }
+
+		std::vector<N> to_vector() const { return std::vector<N>(begin(), end()); }
+	};
+
+	/* A lazy range over all combinations of r elements of a vector, in
+	 * lexicographic order of their positions. Each step updates a single
+	 * array of r indexes in place, so iterating uses O(r) memory no
+	 * matter how many combinations there are, and doesn't allocate
+	 * after the first one.
+	 *
+	 * | std::vector<int> v{1, 2, 3, 4};
+	 * | for (auto c : combination_range<int>(v, 2))
+	 * |	std::cout << c[0] << ',' << c[1] << '\n';
+	 *
+	 * The range refers to the vector, which has to outlive it.
+	 */
+	template<typename N>
+	class combination_range {
+	public:
+		class iterator {
+		private:
+			const std::vector<N> *items = nullptr;
+			std::vector<std::size_t> idx;
+			bool done = true;
+
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = index_view<N>;
+			using difference_type = std::ptrdiff_t;
+			using reference = index_view<N>;
+			using pointer = void;
+
+			iterator() = default;
+			// Starts at the combination with the given indexes
+			iterator(const std::vector<N> &items_, std::vector<std::size_t> start)
+				: items(&items_), idx(std::move(start)), done(idx.size() > items_.size()) {}
+
+			reference operator*() const { return index_view<N>(*items, idx.data(), idx.size()); }
+
+			iterator &operator++() {
+				std::size_t n = items->size(), r = idx.size(), i = r;
+				while (i > 0 && idx[i - 1] == n - r + i - 1)
+					i -= 1;
+				if (i == 0) {
+					done = true;
+					return *this;
+				}
+				idx[i - 1] += 1;
+				for (; i < r; i += 1)
+					idx[i] = idx[i - 1] + 1;
+				return *this;
+			}
+			void operator++(int) { ++*this; }
+
+			// Only meaningful for comparing with the end of the range
+			friend bool operator==(const iterator &a, const iterator &b) {
+				return a.done == b.done && (a.done || a.idx == b.idx);
+			}
+			friend bool operator!=(const iterator &a, const iterator &b) { return !(a == b); }
+		};
+		using const_iterator = iterator;
+
+	private:
+		const std::vector<N> *items;
+		std::size_t r;
+
+	public:
+		combination_range(const std::vector<N> &items_, std::size_t r_)
+			: items(&items_), r(r_) {}
+
+		iterator begin() const {
+			std::vector<std::size_t> idx(r);
+			for (std::size_t i = 0; i < r; i += 1)
+				idx[i] = i;
+			return iterator(*items, std::move(idx));
+		}
+		iterator end() const { return iterator(); }
+
+		// The number of combinations.
+		std::uint64_t size() const { return ncr(items->size(), r); }
+
+		// An iterator starting at the combination with rank k.
+		iterator at(std::uint64_t k) const {
+			return iterator(*items, combination_unrank(items->size(), r, k));
+		}
+
+		// The rank of a combination from this range.
+		std::uint64_t rank(const index_view<N> &c) const {
+			return combination_rank(items->size(), c.indexes(), c.size());
+		}
+	};
+
+	namespace detail {
+		// Splits the ranks of a combination or permutation range into
+		// contiguous slices, one per thread.
+		template<class Range, class Function>
+		void parallel_for_each_rank(const Range &range, Function &fn, unsigned threads) {
+			std::uint64_t total = range.size();
+			if (threads == 0)
+				threads = default_threads();
+			if (total < threads)
+				threads = total;
+			run_threads(threads, [&](unsigned t) {
+					std::uint64_t first = total / threads * t + std::min<std::uint64_t>(t, total % threads);
+					std::uint64_t count = total / threads + (t < total % threads);
+					auto c = range.at(first);
+					for (std::uint64_t n = 0; n < count; n += 1, ++c)
+						fn(*c);
+				});
+		}
+	};
+
+	/* Calls fn with every combination of r elements of items, split into
+	 * contiguous ranges of ranks on separate threads (default_threads()
+	 * if threads is 0). fn is called concurrently, with an index_view. */
+	template<typename N, class Function>
+	void parallel_for_each_combination(const std::vector<N> &items, std::size_t r,
+	                                   Function fn, unsigned threads = 0) {
+		detail::parallel_for_each_rank(combination_range<N>(items, r), fn, threads);
+	}
+
+	/* All the combinations of r elements of a vector, stored back to
+	 * back in one contiguous buffer of C(n, r) * r elements. Iterating
+	 * yields each combination as a row of r elements.
+	 */
+	template<typename N>
+	class flat_combinations {
+	public:
+		/* One combination: r consecutive elements of the buffer */
+		class row {
+		private:
+			const N *b;
+			std::size_t n;
+		public:
+			using value_type = N;
+			using size_type = std::size_t;
+			using const_iterator = const N *;
+			using iterator = const N *;
+
+			row(const N *b_, std::size_t n_) : b(b_), n(n_) {}
+			size_type size() const noexcept { return n; }
+			const N &operator[](size_type i) const { return b[i]; }
+			const N *data() const noexcept { return b; }
+			const N *begin() const noexcept { return b; }
+			const N *end() const noexcept { return b + n; }
+		};
+
+		class const_iterator {
+		private:
+			const N *p = nullptr;
+			std::size_t stride = 0;
+			std::size_t i = 0;
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = row;
+			using difference_type = std::ptrdiff_t;
+			using reference = row;
+			using pointer = void;
+
+			const_iterator() = default;
+			const_iterator(const N *p_, std::size_t stride_, std::size_t i_)
+				: p(p_), stride(stride_), i(i_) {}
+
+			row operator*() const { return row(p + i * stride, stride); }
+			row operator[](difference_type n) const { return row(p + (i + n) * stride, stride); }
+			const_iterator &operator++() { ++i; return *this; }
+			const_iterator operator++(int) { auto t = *this; ++i; return t; }
+			const_iterator &operator--() { --i; return *this; }
+			const_iterator operator--(int) { auto t = *this; --i; return t; }
+			const_iterator &operator+=(difference_type n) { i += n; return *this; }
+			const_iterator &operator-=(difference_type n) { i -= n; return *this; }
+			friend const_iterator operator+(const_iterator a, difference_type n) { return a += n; }
+			friend const_iterator operator+(difference_type n, const_iterator a) { return a += n; }
+			friend const_iterator operator-(const_iterator a, difference_type n) { return a -= n; }
+			friend difference_type operator-(const const_iterator &a, const const_iterator &b) {
+				return a.i - b.i;
+			}
+			friend bool operator==(const const_iterator &a, const const_iterator &b) { return a.i == b.i; }
+			friend bool operator!=(const const_iterator &a, const const_iterator &b) { return a.i != b.i; }
+			friend bool operator<(const const_iterator &a, const const_iterator &b) { return a.i < b.i; }
+			friend bool operator>(const const_iterator &a, const const_iterator &b) { return a.i > b.i; }
+			friend bool operator<=(const const_iterator &a, const const_iterator &b) { return a.i <= b.i; }
+			friend bool operator>=(const const_iterator &a, const const_iterator &b) { return a.i >= b.i; }
+		};
+		using iterator = const_iterator;
+		using value_type = row;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+	private:
+		std::vector<N> buf;
+		std::size_t r;
+		std::size_t count;
+
+	public:
+		// Fills the buffer in one pass, in lexicographic order of positions.
+		flat_combinations(const std::vector<N> &items, std::size_t r_)
+			: r(r_), count(ncr(items.size(), r_)) {
+			buf.reserve(count * r);
+			for (auto c : combination_range<N>(items, r))
+				for (std::size_t i = 0; i < r; i += 1)
+					buf.push_back(c[i]);
+		}
+
+		// The number of combinations
+		size_type size() const noexcept { return count; }
+		bool empty() const noexcept { return count == 0; }
+		// The number of elements in each combination
+		size_type stride() const noexcept { return r; }
+		// All the elements of all the combinations
+		const N *data() const noexcept { return buf.data(); }
+		const std::vector<N> &elements() const noexcept { return buf; }
+
+		row operator[](size_type i) const { return row(buf.data() + i * r, r); }
+		const_iterator begin() const noexcept { return const_iterator(buf.data(), r, 0); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator end() const noexcept { return const_iterator(buf.data(), r, count); }
+		const_iterator cend() const noexcept { return end(); }
+	};
+
 	/* Generate all combinations of R elements from a vector */
 	template<typename N>
 	class combinations {
@@ -48,8 +529,37 @@ namespace useful {
 	public:
 		explicit combinations(std::vector<N> i) : items(std::move(i)) {}
 		explicit combinations(std::vector<N> &&i) : items(i) {}
-		int count(int r) { return ncr(items.size(), r); }
+		std::uint64_t count(int r) { return ncr(items.size(), r); }
 		result_type combos(int r);
+		// All combinations in a single contiguous buffer instead.
+		flat_combinations<N> combos_flat(int r) const {
+			if (r < 0 || static_cast<std::size_t>(r) > items.size())
+				throw std::out_of_range{"combo"};
+			return flat_combinations<N>(items, r);
+		}
+		// All combinations, in lexicographic order, with the vectors
+		// allocated by (rebound copies of) a, like an arena_allocator.
+		template<class Allocator>
+		using alloc_result_type = std::vector<
+			std::vector<N, typename std::allocator_traits<Allocator>::template rebind_alloc<N>>,
+			typename std::allocator_traits<Allocator>::template rebind_alloc<
+				std::vector<N, typename std::allocator_traits<Allocator>::template rebind_alloc<N>>>>;
+		template<class Allocator>
+		alloc_result_type<Allocator> combos(int r, const Allocator &a) const {
+			if (r < 0 || static_cast<std::size_t>(r) > items.size())
+				throw std::out_of_range{"combo"};
+			alloc_result_type<Allocator> res(a);
+			res.reserve(ncr(items.size(), r));
+			for (auto c : combination_range<N>(items, r))
+				res.emplace_back(c.begin(), c.end(), a);
+			return res;
+		}
+		// Lazily generates the combinations one at a time instead.
+		combination_range<N> lazy_combos(int r) const {
+			if (r < 0 || static_cast<std::size_t>(r) > items.size())
+				throw std::out_of_range{"combo"};
+			return combination_range<N>(items, r);
+		}
 	};
 
 	template<typename N>
@@ -80,11 +590,159 @@ namespace useful {
 
 	template<typename N>
 	auto combinations<N>::combos(int r) -> result_type {
-		if (r < 0 || r > items.size())
+		if (r < 0 || static_cast<std::size_t>(r) > items.size())
 			throw std::out_of_range{"combo"};
 		result_type combo;
 		combo.reserve(count(r));
 		gencombos(items, r, combo);
 		return combo;
 	}
-};
\ No newline at end of file
+
+	/* Lehmer codes: map each permutation of r out of n positions to its
+	 * rank in lexicographic order, 0 through P(n, r) - 1, and back. The
+	 * digit for each position is how many of the still unused indexes
+	 * are smaller than the one there. */
+	inline std::uint64_t permutation_rank(std::size_t n, const std::size_t *idx, std::size_t r) {
+		std::uint64_t k = 0;
+		for (std::size_t i = 0; i < r; i += 1) {
+			std::uint64_t digit = idx[i];
+			for (std::size_t j = 0; j < i; j += 1)
+				digit -= idx[j] < idx[i];
+			k += digit * npr(n - 1 - i, r - 1 - i);
+		}
+		return k;
+	}
+
+	inline std::vector<std::size_t> permutation_unrank(std::size_t n, std::size_t r, std::uint64_t k) {
+		if (k >= npr(n, r))
+			throw std::out_of_range{"permutation rank"};
+		std::vector<std::size_t> unused(n), idx(r);
+		std::iota(unused.begin(), unused.end(), 0);
+		for (std::size_t i = 0; i < r; i += 1) {
+			std::uint64_t q = npr(n - 1 - i, r - 1 - i);
+			idx[i] = unused[k / q];
+			unused.erase(unused.begin() + k / q);
+			k %= q;
+		}
+		return idx;
+	}
+
+	/* A lazy range over all permutations of r elements of a vector, in
+	 * lexicographic order of their positions. Works on positions, so the
+	 * elements don't need to be sorted or even comparable. Yields an
+	 * index_view of the current permutation.
+	 *
+	 * The iterator keeps an array of all n indexes: the current
+	 * permutation followed by the unused ones in ascending order. Most
+	 * steps just swap the last position with the next larger unused
+	 * index; only when there isn't one does it fall back to
+	 * std::next_permutation on the indexes. That's one swap per step
+	 * amortized, and O(n) memory.
+	 *
+	 * | std::vector<char> v{'a', 'b', 'c'};
+	 * | for (auto p : permutations<char>(v, 2))
+	 * |	std::cout << p[0] << p[1] << '\n';
+	 *
+	 * The range refers to the vector, which has to outlive it.
+	 */
+	template<typename N>
+	class permutations {
+	public:
+		class iterator {
+		private:
+			const std::vector<N> *items = nullptr;
+			std::vector<std::size_t> state;
+			std::size_t r = 0;
+			bool done = true;
+
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = index_view<N>;
+			using difference_type = std::ptrdiff_t;
+			using reference = index_view<N>;
+			using pointer = void;
+
+			iterator() = default;
+			// Starts at the permutation with the given indexes
+			iterator(const std::vector<N> &items_, std::vector<std::size_t> start)
+				: items(&items_), state(std::move(start)), r(state.size()),
+				  done(r > items_.size()) {
+				if (done)
+					return;
+				std::vector<bool> used(items->size());
+				for (auto i : state)
+					used[i] = true;
+				for (std::size_t i = 0; i < used.size(); i += 1)
+					if (!used[i])
+						state.push_back(i);
+			}
+
+			reference operator*() const { return index_view<N>(*items, state.data(), r); }
+
+			iterator &operator++() {
+				if (r == 0) {
+					done = true;
+					return *this;
+				}
+				auto first = state.begin(), mid = first + r, last = state.end();
+				auto next = std::upper_bound(mid, last, state[r - 1]);
+				if (next != last) {
+					std::iter_swap(mid - 1, next);
+				} else {
+					// Every position after the changed one gets reset, so
+					// make the unused tail descending and let
+					// next_permutation sort it all back into ascending order.
+					std::reverse(mid, last);
+					done = !std::next_permutation(first, last);
+				}
+				return *this;
+			}
+			void operator++(int) { ++*this; }
+
+			// Only meaningful for comparing with the end of the range
+			friend bool operator==(const iterator &a, const iterator &b) {
+				return a.done == b.done && (a.done || a.state == b.state);
+			}
+			friend bool operator!=(const iterator &a, const iterator &b) { return !(a == b); }
+		};
+		using const_iterator = iterator;
+
+	private:
+		const std::vector<N> *items;
+		std::size_t r;
+
+	public:
+		permutations(const std::vector<N> &items_, std::size_t r_) : items(&items_), r(r_) {}
+
+		iterator begin() const {
+			std::vector<std::size_t> idx(std::min(r, items->size() + 1));
+			std::iota(idx.begin(), idx.end(), 0);
+			return iterator(*items, std::move(idx));
+		}
+		iterator end() const { return iterator(); }
+
+		// The number of permutations.
+		std::uint64_t size() const { return npr(items->size(), r); }
+
+		// An iterator starting at the permutation with rank k.
+		iterator at(std::uint64_t k) const {
+			return iterator(*items, permutation_unrank(items->size(), r, k));
+		}
+
+		// The rank of a permutation from this range.
+		std::uint64_t rank(const index_view<N> &p) const {
+			return permutation_rank(items->size(), p.indexes(), p.size());
+		}
+	};
+
+	/* Calls fn with every permutation of r elements of items, split into
+	 * contiguous ranges of ranks on separate threads (default_threads()
+	 * if threads is 0). fn is called concurrently, with an index_view. */
+	template<typename N, class Function>
+	void parallel_for_each_permutation(const std::vector<N> &items, std::size_t r,
+	                                   Function fn, unsigned threads = 0) {
+		detail::parallel_for_each_rank(permutations<N>(items, r), fn, threads);
+	}
+};
+
+#endif
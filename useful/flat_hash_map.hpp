@@ -0,0 +1,563 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 shawnw
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef USEFUL_FLAT_HASH_MAP_HPP
+#define USEFUL_FLAT_HASH_MAP_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <tuple>
+#include <iterator>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace useful {
+
+  namespace detail {
+    // Control byte values. Full slots hold the low 7 bits of the hash.
+    constexpr std::int8_t ctrl_empty = -128;
+    constexpr std::int8_t ctrl_deleted = -2;
+    constexpr std::int8_t ctrl_sentinel = -1;
+    constexpr std::size_t ctrl_group_size = 16;
+
+    // Finalizer from MurmurHash3, to spread poor hashes (like the
+    // identity hash of integers) over all bits.
+    inline std::uint64_t mix_hash(std::uint64_t h) noexcept {
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return h;
+    }
+
+    inline unsigned lowest_bit(unsigned m) noexcept {
+#ifdef __GNUC__
+      return __builtin_ctz(m);
+#else
+      unsigned n = 0;
+      while (!(m & 1)) {
+        m >>= 1;
+        n += 1;
+      }
+      return n;
+#endif
+    }
+
+    // A group of 16 control bytes, probed all at once. The match
+    // functions return a bitmask of matching positions.
+    class ctrl_group {
+#ifdef __SSE2__
+    private:
+      __m128i g;
+    public:
+      explicit ctrl_group(const std::int8_t *p)
+        : g(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) {}
+      unsigned match(std::int8_t h) const {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), g));
+      }
+      unsigned match_empty() const { return match(ctrl_empty); }
+      unsigned match_free() const {
+        return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), g));
+      }
+#else
+    private:
+      const std::int8_t *p;
+    public:
+      explicit ctrl_group(const std::int8_t *p_) : p(p_) {}
+      unsigned match(std::int8_t h) const {
+        unsigned m = 0;
+        for (std::size_t i = 0; i < ctrl_group_size; i += 1)
+          m |= unsigned(p[i] == h) << i;
+        return m;
+      }
+      unsigned match_empty() const { return match(ctrl_empty); }
+      unsigned match_free() const {
+        unsigned m = 0;
+        for (std::size_t i = 0; i < ctrl_group_size; i += 1)
+          m |= unsigned(p[i] < ctrl_sentinel) << i;
+        return m;
+      }
+#endif
+    };
+  };
+
+  /* A transparent string hash, so maps keyed on std::string can be
+   * searched with string_views and C strings without making a
+   * std::string. */
+  struct string_hash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const noexcept {
+      return std::hash<std::string_view>()(s);
+    }
+  };
+
+  /* An unordered map using open addressing in one flat array of slots,
+   * in the style of Abseil's SwissTable. A parallel array of one byte per
+   * slot holds 7 bits of each key's hash, and lookups compare 16 of
+   * those at a time (with SSE2 when available), so most probes never
+   * touch a key that doesn't match.
+   *
+   * If both Hash and KeyEqual have an is_transparent member type, the
+   * lookup functions accept anything they can hash and compare with a
+   * key. See flat_string_map.
+   *
+   * Iteration is in slot order. Unlike std::unordered_map, references,
+   * pointers and iterators are invalidated by any insertion that grows
+   * the table, and iterators by erasure of the element they point to.
+   */
+  template<class Key, class T, class Hash = std::hash<Key>,
+           class KeyEqual = std::equal_to<Key>>
+  class flat_hash_map {
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+
+    template<bool Const>
+    class basic_iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::pair<const Key, T>;
+      using difference_type = std::ptrdiff_t;
+      using reference = typename std::conditional<Const, const value_type &, value_type &>::type;
+      using pointer = typename std::conditional<Const, const value_type *, value_type *>::type;
+
+    private:
+      friend class flat_hash_map;
+      const std::int8_t *ctrl = nullptr;
+      value_type *slot = nullptr;
+
+      basic_iterator(const std::int8_t *c, value_type *s) : ctrl(c), slot(s) {}
+      void skip() {
+        while (*ctrl < detail::ctrl_sentinel) {
+          ++ctrl;
+          ++slot;
+        }
+      }
+
+    public:
+
+      basic_iterator() = default;
+      template<bool C = Const, typename = typename std::enable_if<C>::type>
+      basic_iterator(const basic_iterator<false> &i) : ctrl(i.ctrl), slot(i.slot) {}
+
+      reference operator*() const { return *slot; }
+      pointer operator->() const { return slot; }
+      basic_iterator &operator++() {
+        ++ctrl;
+        ++slot;
+        skip();
+        return *this;
+      }
+      basic_iterator operator++(int) {
+        auto tmp = *this;
+        ++*this;
+        return tmp;
+      }
+      friend bool operator==(const basic_iterator &a, const basic_iterator &b) {
+        return a.slot == b.slot;
+      }
+      friend bool operator!=(const basic_iterator &a, const basic_iterator &b) {
+        return a.slot != b.slot;
+      }
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+  private:
+    static constexpr size_type npos = ~size_type(0);
+
+    // capacity_ is 0 or a power of two >= 16. ctrl_ has capacity_
+    // control bytes, followed by a sentinel that stops iteration.
+    std::int8_t *ctrl_ = nullptr;
+    value_type *slots_ = nullptr;
+    size_type size_ = 0;
+    size_type deleted_ = 0;
+    size_type capacity_ = 0;
+    Hash hash_;
+    KeyEqual eq_;
+    std::allocator<value_type> alloc_;
+
+    template<class H, class E, class = void>
+    struct transparent : std::false_type {};
+    template<class H, class E>
+    struct transparent<H, E, std::void_t<typename H::is_transparent,
+                                         typename E::is_transparent>> : std::true_type {};
+
+    // Lookups with K are allowed if it's the key type or the functors
+    // are transparent.
+    template<class K>
+    using lookup_key = typename std::enable_if<
+      std::is_same<K, Key>::value || transparent<Hash, KeyEqual>::value, K>::type;
+
+    static size_type max_load(size_type cap) { return cap - cap / 8; }
+
+    template<class K>
+    std::uint64_t hash_of(const K &k) const {
+      return detail::mix_hash(hash_(k));
+    }
+    static std::int8_t h2(std::uint64_t h) { return h & 0x7f; }
+
+    template<class K>
+    size_type find_index(const K &k, std::uint64_t h) const {
+      if (capacity_ == 0)
+        return npos;
+      size_type gmask = capacity_ / detail::ctrl_group_size - 1;
+      size_type g = (h >> 7) & gmask;
+      for (size_type step = 1; ; step += 1) {
+        size_type base = g * detail::ctrl_group_size;
+        detail::ctrl_group grp(ctrl_ + base);
+        for (unsigned m = grp.match(h2(h)); m; m &= m - 1) {
+          size_type i = base + detail::lowest_bit(m);
+          if (eq_(slots_[i].first, k))
+            return i;
+        }
+        if (grp.match_empty())
+          return npos;
+        g = (g + step) & gmask;
+      }
+    }
+
+    size_type find_free(std::uint64_t h) const {
+      size_type gmask = capacity_ / detail::ctrl_group_size - 1;
+      size_type g = (h >> 7) & gmask;
+      for (size_type step = 1; ; step += 1) {
+        size_type base = g * detail::ctrl_group_size;
+        if (unsigned m = detail::ctrl_group(ctrl_ + base).match_free())
+          return base + detail::lowest_bit(m);
+        g = (g + step) & gmask;
+      }
+    }
+
+    void deallocate() {
+      if (!ctrl_)
+        return;
+      for (size_type i = 0; i < capacity_; i += 1)
+        if (ctrl_[i] >= 0)
+          slots_[i].~value_type();
+      alloc_.deallocate(slots_, capacity_);
+      delete[] ctrl_;
+      ctrl_ = nullptr;
+      slots_ = nullptr;
+    }
+
+    void rehash(size_type cap) {
+      std::unique_ptr<std::int8_t[]> nctrl(new std::int8_t[cap + 1]);
+      std::fill(nctrl.get(), nctrl.get() + cap, detail::ctrl_empty);
+      nctrl[cap] = detail::ctrl_sentinel;
+      value_type *nslots = alloc_.allocate(cap);
+
+      std::int8_t *octrl = ctrl_;
+      value_type *oslots = slots_;
+      size_type ocap = capacity_;
+      ctrl_ = nctrl.release();
+      slots_ = nslots;
+      capacity_ = cap;
+      deleted_ = 0;
+      for (size_type i = 0; i < ocap; i += 1) {
+        if (octrl[i] < 0)
+          continue;
+        std::uint64_t h = hash_of(oslots[i].first);
+        size_type j = find_free(h);
+        // The old element is destroyed right after this, so moving from
+        // its const key is safe.
+        ::new (static_cast<void *>(slots_ + j))
+          value_type(std::move(const_cast<Key &>(oslots[i].first)),
+                     std::move(oslots[i].second));
+        ctrl_[j] = h2(h);
+        oslots[i].~value_type();
+      }
+      if (octrl) {
+        alloc_.deallocate(oslots, ocap);
+        delete[] octrl;
+      }
+    }
+
+    // Makes room for one more element.
+    void prepare_insert() {
+      if (size_ + deleted_ + 1 <= max_load(capacity_))
+        return;
+      if (capacity_ == 0)
+        rehash(detail::ctrl_group_size);
+      else if (deleted_ > capacity_ / 4)
+        rehash(capacity_); // Mostly tombstones; clean up in place.
+      else
+        rehash(capacity_ * 2);
+    }
+
+    template<class K, class... Args>
+    std::pair<iterator, bool> try_emplace_impl(K &&k, Args &&...args) {
+      std::uint64_t h = hash_of(k);
+      size_type i = find_index(k, h);
+      if (i != npos)
+        return {iterator(ctrl_ + i, slots_ + i), false};
+      prepare_insert();
+      i = find_free(h);
+      ::new (static_cast<void *>(slots_ + i))
+        value_type(std::piecewise_construct,
+                   std::forward_as_tuple(std::forward<K>(k)),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+      if (ctrl_[i] == detail::ctrl_deleted)
+        deleted_ -= 1;
+      ctrl_[i] = h2(h);
+      size_ += 1;
+      return {iterator(ctrl_ + i, slots_ + i), true};
+    }
+
+    void erase_index(size_type i) {
+      slots_[i].~value_type();
+      size_ -= 1;
+      // If the group already has an empty slot, no probe sequence ever
+      // continued past it, so this slot can be marked empty too.
+      size_type base = i & ~(detail::ctrl_group_size - 1);
+      if (detail::ctrl_group(ctrl_ + base).match_empty()) {
+        ctrl_[i] = detail::ctrl_empty;
+      } else {
+        ctrl_[i] = detail::ctrl_deleted;
+        deleted_ += 1;
+      }
+    }
+
+  public:
+    flat_hash_map() = default;
+
+    explicit flat_hash_map(size_type n, const Hash &h = Hash(),
+                           const KeyEqual &e = KeyEqual())
+      : hash_(h), eq_(e) {
+      reserve(n);
+    }
+
+    template<class InputIterator>
+    flat_hash_map(InputIterator first, InputIterator last) {
+      insert(first, last);
+    }
+
+    flat_hash_map(std::initializer_list<value_type> il) {
+      insert(il.begin(), il.end());
+    }
+
+    flat_hash_map(const flat_hash_map &o) : hash_(o.hash_), eq_(o.eq_) {
+      reserve(o.size());
+      insert(o.begin(), o.end());
+    }
+
+    flat_hash_map(flat_hash_map &&o) noexcept
+      : ctrl_(std::exchange(o.ctrl_, nullptr)),
+        slots_(std::exchange(o.slots_, nullptr)),
+        size_(std::exchange(o.size_, 0)),
+        deleted_(std::exchange(o.deleted_, 0)),
+        capacity_(std::exchange(o.capacity_, 0)),
+        hash_(o.hash_), eq_(o.eq_) {}
+
+    flat_hash_map &operator=(flat_hash_map o) noexcept {
+      swap(o);
+      return *this;
+    }
+
+    ~flat_hash_map() { deallocate(); }
+
+    void swap(flat_hash_map &o) noexcept {
+      using std::swap;
+      swap(ctrl_, o.ctrl_);
+      swap(slots_, o.slots_);
+      swap(size_, o.size_);
+      swap(deleted_, o.deleted_);
+      swap(capacity_, o.capacity_);
+      swap(hash_, o.hash_);
+      swap(eq_, o.eq_);
+    }
+
+    iterator begin() noexcept {
+      if (!ctrl_)
+        return end();
+      iterator i(ctrl_, slots_);
+      i.skip();
+      return i;
+    }
+    const_iterator begin() const noexcept {
+      return const_cast<flat_hash_map *>(this)->begin();
+    }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+    const_iterator end() const noexcept {
+      return const_cast<flat_hash_map *>(this)->end();
+    }
+    const_iterator cend() const noexcept { return end(); }
+
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_type capacity() const noexcept { return capacity_; }
+    float load_factor() const noexcept {
+      return capacity_ ? float(size_) / capacity_ : 0.0f;
+    }
+    hasher hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+
+    // Makes sure n elements fit without growing the table.
+    void reserve(size_type n) {
+      size_type cap = detail::ctrl_group_size;
+      while (max_load(cap) < n)
+        cap *= 2;
+      if (cap > capacity_)
+        rehash(cap);
+    }
+
+    void clear() noexcept {
+      for (size_type i = 0; i < capacity_; i += 1) {
+        if (ctrl_[i] >= 0)
+          slots_[i].~value_type();
+        ctrl_[i] = detail::ctrl_empty;
+      }
+      size_ = deleted_ = 0;
+    }
+
+    template<class K, class = lookup_key<K>>
+    iterator find(const K &k) {
+      size_type i = find_index(k, hash_of(k));
+      return i == npos ? end() : iterator(ctrl_ + i, slots_ + i);
+    }
+    template<class K, class = lookup_key<K>>
+    const_iterator find(const K &k) const {
+      return const_cast<flat_hash_map *>(this)->find(k);
+    }
+    iterator find(const Key &k) { return find<Key>(k); }
+    const_iterator find(const Key &k) const { return find<Key>(k); }
+
+    template<class K, class = lookup_key<K>>
+    bool contains(const K &k) const { return find_index(k, hash_of(k)) != npos; }
+    bool contains(const Key &k) const { return contains<Key>(k); }
+
+    template<class K, class = lookup_key<K>>
+    size_type count(const K &k) const { return contains(k); }
+    size_type count(const Key &k) const { return contains(k); }
+
+    T &at(const Key &k) {
+      auto i = find(k);
+      if (i == end())
+        throw std::out_of_range{"flat_hash_map::at"};
+      return i->second;
+    }
+    const T &at(const Key &k) const {
+      return const_cast<flat_hash_map *>(this)->at(k);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const Key &k, Args &&...args) {
+      return try_emplace_impl(k, std::forward<Args>(args)...);
+    }
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(Key &&k, Args &&...args) {
+      return try_emplace_impl(std::move(k), std::forward<Args>(args)...);
+    }
+    // With transparent functors, only makes a Key from k if it isn't
+    // already in the map.
+    template<class K, class... Args, class = lookup_key<K>,
+             class = typename std::enable_if<!std::is_convertible<K &&, const Key &>::value
+                                             || std::is_same<K, Key>::value>::type>
+    std::pair<iterator, bool> try_emplace(K &&k, Args &&...args) {
+      return try_emplace_impl(std::forward<K>(k), std::forward<Args>(args)...);
+    }
+
+    T &operator[](const Key &k) { return try_emplace(k).first->second; }
+    T &operator[](Key &&k) { return try_emplace(std::move(k)).first->second; }
+    template<class K, class = lookup_key<K>>
+    T &operator[](const K &k) { return try_emplace_impl(k).first->second; }
+
+    std::pair<iterator, bool> insert(const value_type &v) {
+      return try_emplace_impl(v.first, v.second);
+    }
+    std::pair<iterator, bool> insert(value_type &&v) {
+      return try_emplace_impl(v.first, std::move(v.second));
+    }
+    template<class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+      for (; first != last; ++first)
+        insert(*first);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> emplace(Args &&...args) {
+      value_type v(std::forward<Args>(args)...);
+      return try_emplace_impl(std::move(const_cast<Key &>(v.first)), std::move(v.second));
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const Key &k, M &&m) {
+      auto r = try_emplace(k, std::forward<M>(m));
+      if (!r.second)
+        r.first->second = std::forward<M>(m);
+      return r;
+    }
+
+    iterator erase(const_iterator pos) {
+      size_type i = pos.slot - slots_;
+      erase_index(i);
+      iterator next(ctrl_ + i, slots_ + i);
+      ++next;
+      return next;
+    }
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+    template<class K, class = lookup_key<K>>
+    size_type erase(const K &k) {
+      size_type i = find_index(k, hash_of(k));
+      if (i == npos)
+        return 0;
+      erase_index(i);
+      return 1;
+    }
+    size_type erase(const Key &k) { return erase<Key>(k); }
+  };
+
+  template<class Key, class T, class Hash, class KeyEqual>
+  void swap(flat_hash_map<Key, T, Hash, KeyEqual> &a,
+            flat_hash_map<Key, T, Hash, KeyEqual> &b) noexcept {
+    a.swap(b);
+  }
+
+  /* A flat_hash_map with std::string keys that can be looked up with
+   * string_views without copying them. */
+  template<class T>
+  using flat_string_map = flat_hash_map<std::string, T, string_hash, std::equal_to<>>;
+};
+
+#endif
@@ -0,0 +1,380 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 shawnw
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef USEFUL_HEAVY_HITTERS_HPP
+#define USEFUL_HEAVY_HITTERS_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "useful/flat_hash_map.hpp"
+
+/* Fixed memory summaries of unbounded streams, for finding the most
+ * frequent items without keeping a count for every distinct one.
+ * Both kinds can be merged, so each thread or shard can keep its own
+ * and combine them at the end.
+ */
+
+namespace useful {
+
+  /* The Space-Saving algorithm (Metwally, Agrawal and El Abbadi, 2005)
+   * with the stream-summary structure, so adding an item is O(1) (for
+   * unit weights). Monitors at most capacity() keys. Every item that
+   * occurs more than total() / capacity() times is monitored, and the
+   * count of a monitored item overestimates its true count by at most
+   * its error, which is itself at most total() / capacity().
+   *
+   * With transparent Hash and KeyEqual (like string_hash and
+   * std::equal_to<>), add() and estimate() accept anything those do,
+   * and only make a Key when a new item starts being monitored.
+   */
+  template<class Key, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+  class space_saving {
+  public:
+    struct entry {
+      Key key;
+      std::uint64_t count;
+      std::uint64_t error;
+      // A lower bound on the true count
+      std::uint64_t guaranteed() const { return count - error; }
+    };
+
+  private:
+    using index = std::uint32_t;
+    static constexpr index nil = ~index(0);
+
+    struct counter {
+      Key key;
+      std::uint64_t error;
+      index bucket, prev, next;
+    };
+    // Counters with the same count are kept in a list hanging off a
+    // bucket, and buckets in a list in ascending order of count.
+    struct bucket {
+      std::uint64_t count;
+      index first, prev, next;
+    };
+
+    std::size_t k;
+    std::uint64_t total_ = 0;
+    // An upper bound on the count of a key that isn't monitored while
+    // there are free counters. Only a merge makes it nonzero.
+    std::uint64_t floor_ = 0;
+    std::vector<counter> counters;
+    std::vector<bucket> buckets;
+    std::vector<index> free_buckets;
+    index min_bucket = nil, max_bucket = nil;
+    flat_hash_map<Key, index, Hash, KeyEqual> where;
+
+    index new_bucket(std::uint64_t count, index prev, index next) {
+      index b;
+      if (free_buckets.empty()) {
+        b = buckets.size();
+        buckets.push_back(bucket{});
+      } else {
+        b = free_buckets.back();
+        free_buckets.pop_back();
+      }
+      buckets[b] = bucket{count, nil, prev, next};
+      (prev == nil ? min_bucket : buckets[prev].next) = b;
+      (next == nil ? max_bucket : buckets[next].prev) = b;
+      return b;
+    }
+
+    void remove_bucket(index b) {
+      bucket &bk = buckets[b];
+      (bk.prev == nil ? min_bucket : buckets[bk.prev].next) = bk.next;
+      (bk.next == nil ? max_bucket : buckets[bk.next].prev) = bk.prev;
+      free_buckets.push_back(b);
+    }
+
+    void detach(index c) {
+      counter &ct = counters[c];
+      if (ct.prev == nil)
+        buckets[ct.bucket].first = ct.next;
+      else
+        counters[ct.prev].next = ct.next;
+      if (ct.next != nil)
+        counters[ct.next].prev = ct.prev;
+    }
+
+    void attach(index c, index b) {
+      counter &ct = counters[c];
+      ct.bucket = b;
+      ct.prev = nil;
+      ct.next = buckets[b].first;
+      if (ct.next != nil)
+        counters[ct.next].prev = c;
+      buckets[b].first = c;
+    }
+
+    // Puts a detached counter in the bucket for count, searching
+    // forward from bucket from (which has a count <= count), or from
+    // the smallest bucket if from is nil.
+    void place(index c, std::uint64_t count, index from) {
+      if (from == nil) {
+        if (min_bucket == nil || buckets[min_bucket].count > count) {
+          attach(c, new_bucket(count, nil, min_bucket));
+          return;
+        }
+        from = min_bucket;
+      }
+      while (buckets[from].next != nil && buckets[buckets[from].next].count <= count)
+        from = buckets[from].next;
+      if (buckets[from].count == count)
+        attach(c, from);
+      else
+        attach(c, new_bucket(count, from, buckets[from].next));
+    }
+
+    void increment(index c, std::uint64_t w) {
+      index b = counters[c].bucket;
+      detach(c);
+      place(c, buckets[b].count + w, b);
+      if (buckets[b].first == nil)
+        remove_bucket(b);
+    }
+
+    template<class K>
+    void insert(const K &key, std::uint64_t count, std::uint64_t error) {
+      index c = counters.size();
+      counters.push_back(counter{Key(key), error, nil, nil, nil});
+      where.try_emplace(counters[c].key, c);
+      place(c, count, nil);
+    }
+
+    // Replaces the key of a least frequent item with key, which
+    // inherits its count as error.
+    template<class K>
+    void replace_min(const K &key, std::uint64_t w) {
+      index b = min_bucket;
+      index c = buckets[b].first;
+      where.erase(counters[c].key);
+      counters[c].key = Key(key);
+      counters[c].error = buckets[b].count;
+      where.try_emplace(counters[c].key, c);
+      detach(c);
+      place(c, buckets[b].count + w, b);
+      if (buckets[b].first == nil)
+        remove_bucket(b);
+    }
+
+  public:
+    // Monitors up to capacity distinct keys.
+    explicit space_saving(std::size_t capacity) : k(capacity) {
+      if (capacity == 0 || capacity >= nil)
+        throw std::out_of_range{"space_saving capacity"};
+      counters.reserve(k);
+      where.reserve(k);
+    }
+
+    // Adds w occurrences of key.
+    template<class K>
+    void add(const K &key, std::uint64_t w = 1) {
+      if (w == 0)
+        return;
+      total_ += w;
+      auto i = where.find(key);
+      if (i != where.end())
+        increment(i->second, w);
+      else if (counters.size() < k)
+        insert(key, floor_ + w, floor_);
+      else
+        replace_min(key, w);
+    }
+
+    // An upper bound on the number of times key has been seen.
+    template<class K>
+    std::uint64_t estimate(const K &key) const {
+      auto i = where.find(key);
+      if (i != where.end())
+        return buckets[counters[i->second].bucket].count;
+      return floor();
+    }
+
+    // An upper bound on the number of times any key that isn't
+    // monitored has been seen.
+    std::uint64_t floor() const {
+      return counters.size() < k ? floor_ : buckets[min_bucket].count;
+    }
+
+    // Up to n monitored items, most frequent first.
+    std::vector<entry> top(std::size_t n) const {
+      std::vector<entry> res;
+      res.reserve(std::min(n, counters.size()));
+      for (index b = max_bucket; b != nil && res.size() < n; b = buckets[b].prev)
+        for (index c = buckets[b].first; c != nil && res.size() < n; c = counters[c].next)
+          res.push_back(entry{counters[c].key, buckets[b].count, counters[c].error});
+      return res;
+    }
+
+    // Adds the items summarized by o, keeping the capacity of this
+    // one. The error bounds of the result are the sums of the two
+    // (Agarwal et al., "Mergeable Summaries", 2012). o can have a
+    // different capacity.
+    template<class H, class E>
+    void merge(const space_saving<Key, H, E> &o) {
+      std::uint64_t min_this = floor();
+      std::uint64_t min_o = o.floor();
+      auto mine = top(size());
+      flat_hash_map<Key, std::size_t, Hash, KeyEqual> pos;
+      pos.reserve(mine.size() + o.size());
+      for (std::size_t n = 0; n < mine.size(); n += 1) {
+        mine[n].count += min_o;
+        mine[n].error += min_o;
+        pos.try_emplace(mine[n].key, n);
+      }
+      for (auto &e : o.top(o.size())) {
+        auto i = pos.find(e.key);
+        if (i != pos.end()) {
+          mine[i->second].count += e.count - min_o;
+          mine[i->second].error += e.error - min_o;
+        } else {
+          pos.try_emplace(e.key, mine.size());
+          mine.push_back(entry{e.key, e.count + min_this, e.error + min_this});
+        }
+      }
+      auto bigger = [](const entry &a, const entry &b) { return a.count > b.count; };
+      if (mine.size() > k) {
+        std::nth_element(mine.begin(), mine.begin() + k, mine.end(), bigger);
+        mine.resize(k);
+      }
+      std::sort(mine.begin(), mine.end(), bigger);
+
+      std::uint64_t total = total_ + o.total();
+      clear();
+      total_ = total;
+      floor_ = min_this + min_o;
+      // Smallest first, so every insert lands at the end of the bucket list.
+      for (auto e = mine.rbegin(); e != mine.rend(); ++e) {
+        index c = counters.size();
+        counters.push_back(counter{std::move(e->key), e->error, nil, nil, nil});
+        where.try_emplace(counters[c].key, c);
+        place(c, e->count, max_bucket);
+      }
+    }
+
+    // The total weight of everything added.
+    std::uint64_t total() const noexcept { return total_; }
+    // The number of keys monitored.
+    std::size_t size() const noexcept { return counters.size(); }
+    std::size_t capacity() const noexcept { return k; }
+
+    void clear() {
+      total_ = 0;
+      floor_ = 0;
+      counters.clear();
+      buckets.clear();
+      free_buckets.clear();
+      min_bucket = max_bucket = nil;
+      where.clear();
+    }
+  };
+
+  /* A Count-Min sketch (Cormode and Muthukrishnan, 2005): depth rows of
+   * width counters. The estimated count of a key never undercounts, and
+   * overcounts by more than e / width * total() with probability at
+   * most exp(-depth). Uses conservative update, which only raises the
+   * counters that need it and keeps the estimates tighter.
+   *
+   * It keeps no keys, so it can estimate the frequency of any item but
+   * can't list the frequent ones by itself. Pair it with space_saving
+   * for that.
+   */
+  template<class Key, class Hash = std::hash<Key>>
+  class count_min_sketch {
+  private:
+    std::size_t width_, depth_;
+    std::uint64_t total_ = 0;
+    std::vector<std::uint64_t> table;
+    Hash hash;
+
+    // Row i uses the hash h1 + i * h2 (Kirsch and Mitzenmacher).
+    template<class K>
+    std::pair<std::uint64_t, std::uint64_t> hashes(const K &key) const {
+      std::uint64_t h = detail::mix_hash(hash(key));
+      return {h, detail::mix_hash(h ^ 0x9e3779b97f4a7c15ULL) | 1};
+    }
+
+  public:
+    count_min_sketch(std::size_t width, std::size_t depth)
+      : width_(width), depth_(depth), table(width * depth) {
+      if (width == 0 || depth == 0)
+        throw std::out_of_range{"count_min_sketch size"};
+    }
+
+    // A sketch that overcounts by at most epsilon * total() with
+    // probability 1 - delta.
+    static count_min_sketch with_error(double epsilon, double delta) {
+      return count_min_sketch(std::ceil(std::exp(1.0) / epsilon),
+                              std::ceil(std::log(1.0 / delta)));
+    }
+
+    template<class K>
+    void add(const K &key, std::uint64_t w = 1) {
+      auto h = hashes(key);
+      std::uint64_t est = estimate(key) + w;
+      for (std::size_t i = 0; i < depth_; i += 1) {
+        std::uint64_t &c = table[i * width_ + (h.first + i * h.second) % width_];
+        if (c < est)
+          c = est;
+      }
+      total_ += w;
+    }
+
+    template<class K>
+    std::uint64_t estimate(const K &key) const {
+      auto h = hashes(key);
+      std::uint64_t est = ~std::uint64_t(0);
+      for (std::size_t i = 0; i < depth_; i += 1)
+        est = std::min(est, table[i * width_ + (h.first + i * h.second) % width_]);
+      return est;
+    }
+
+    // Adds the counts of a sketch of the same size.
+    void merge(const count_min_sketch &o) {
+      if (o.width_ != width_ || o.depth_ != depth_)
+        throw std::invalid_argument{"count_min_sketch sizes differ"};
+      for (std::size_t i = 0; i < table.size(); i += 1)
+        table[i] += o.table[i];
+      total_ += o.total_;
+    }
+
+    std::uint64_t total() const noexcept { return total_; }
+    std::size_t width() const noexcept { return width_; }
+    std::size_t depth() const noexcept { return depth_; }
+
+    void clear() {
+      std::fill(table.begin(), table.end(), 0);
+      total_ = 0;
+    }
+  };
+};
+
+#endif
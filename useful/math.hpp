@@ -27,41 +27,541 @@ SOFTWARE.
 
 #include <numeric>
 #include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <iterator>
+#include <atomic>
+#include <algorithm>
+
+#include "useful/thread.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define USEFUL_MATH_X86 1
+#include <immintrin.h>
+#endif
 
 namespace useful {
 
-	/* Returns the factorial of a number. */
+	namespace detail {
+		// 0! through 20!, all the factorials that fit in 64 bits. A
+		// class template so the array can be defined in a header.
+		template<class = void>
+		struct factorial_table {
+			static constexpr std::size_t size = 21;
+			static constexpr std::uint64_t v[size] = {
+				1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880, 3628800, 39916800,
+				479001600, 6227020800, 87178291200, 1307674368000, 20922789888000,
+				355687428096000, 6402373705728000, 121645100408832000,
+				2432902008176640000
+			};
+		};
+		template<class D> constexpr std::size_t factorial_table<D>::size;
+		template<class D> constexpr std::uint64_t factorial_table<D>::v[];
+		using factorials = factorial_table<>;
+
+		// The largest value of T. Falls back on all bits set for
+		// unsigned types numeric_limits doesn't know about, like
+		// unsigned __int128 in strict ISO mode.
+		template<typename T>
+		constexpr T max_value(std::true_type) { return std::numeric_limits<T>::max(); }
+		template<typename T>
+		constexpr T max_value(std::false_type) { return static_cast<T>(~static_cast<T>(0)); }
+		template<typename T>
+		constexpr T max_value() {
+			return max_value<T>(std::integral_constant<bool, std::numeric_limits<T>::is_specialized>());
+		}
+
+		// a * b, throwing std::overflow_error if it doesn't fit in T
+		template<typename T>
+		constexpr T checked_multiply(T a, T b, const char *what) {
+			return b != 0 && a > max_value<T>() / b ? throw std::overflow_error{what} : a * b;
+		}
+
+		// lo * (lo + 1) * ... * (lo + count - 1), multiplied in halves so
+		// the recursion is only log(count) deep.
+		template<typename T>
+		constexpr T product_of_range(T lo, std::uint64_t count) {
+			return count == 0 ? T(1) : count == 1 ? lo
+				: product_of_range(lo, count / 2) * product_of_range(lo + T(count / 2), count - count / 2);
+		}
+
+		// i * (i + 1) * ... * n times acc, checking each step for overflow.
+		// The recursion can't go deeper than it takes to overflow T.
+		template<typename T>
+		constexpr T checked_product_of_range(T i, T n, T acc, const char *what) {
+			return i > n ? acc : checked_product_of_range(i + 1, n, checked_multiply<T>(acc, i, what), what);
+		}
+
+		template<typename T>
+		constexpr T factorial(T n, std::false_type) {
+			return n < 2 ? T(1) : product_of_range(T(2), static_cast<std::uint64_t>(n) - 1);
+		}
+
+		template<typename T>
+		constexpr T factorial(T n, std::true_type) {
+			return n < static_cast<T>(factorials::size) ? (n <= 1 ? T(1) : static_cast<T>(factorials::v[n]))
+				: factorial(n, std::false_type());
+		}
+	};
+
+	/* Returns the factorial of a number. Integer types up to 64 bits
+	 * use a table; anything else, like unsigned __int128 or double,
+	 * multiplies it out. Silently overflows if the result doesn't fit;
+	 * see factorial_checked(). */
 	template<typename T>
 	constexpr T factorial(T n) {
-		return n == 1 ? 1 : n * factorial<T>(n - 1);
+		return detail::factorial(n, std::integral_constant<bool, std::is_integral<T>::value
+		                                                   && sizeof(T) <= sizeof(std::uint64_t)>());
+	}
+
+	/* Like factorial(), but throws std::overflow_error if the result
+	 * doesn't fit in T. */
+	template<typename T>
+	constexpr T factorial_checked(T n) {
+		return detail::checked_product_of_range<T>(2, n, 1, "factorial");
+	}
+
+	/* The natural logarithm of n!, for when n! is too big to represent. */
+	inline double log_factorial(double n) {
+		return std::lgamma(n + 1.0);
 	}
 
-	/* Returns the sum of a range */
+	/* How sum() adds up floating point numbers in contiguous memory.
+	 *
+	 * fast: The default. Several independent accumulators, using SSE or
+	 *  AVX when the CPU has them. Reorders the additions, so the result
+	 *  can differ from a serial loop in the last bits.
+	 * pairwise: Recursive pairwise summation. Error grows with log(n)
+	 *  instead of n, for little extra cost.
+	 * kahan: Kahan compensated summation. Error doesn't grow with n,
+	 *  but it's several times slower. Don't compile
+	 *  it with -ffast-math, which optimizes the compensation away.
+	 *
+	 * Integer sums are exact and always use the fast path.
+	 */
+	enum class summation { fast, pairwise, kahan };
+
+	namespace detail {
+		template<class T, bool Mul>
+		inline T reduce_op(T a, T b) { return Mul ? a * b : a + b; }
+
+		// Eight independent accumulators, so the additions don't all
+		// wait on each other and the compiler is free to vectorize.
+		template<class T, bool Mul>
+		T reduce_unrolled(const T *p, std::size_t n) {
+			const T id = Mul ? 1 : 0;
+			T a[8] = {id, id, id, id, id, id, id, id};
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8)
+				for (int j = 0; j < 8; j += 1)
+					a[j] = reduce_op<T, Mul>(a[j], p[i + j]);
+			T r = reduce_op<T, Mul>(reduce_op<T, Mul>(reduce_op<T, Mul>(a[0], a[1]), reduce_op<T, Mul>(a[2], a[3])),
+			                        reduce_op<T, Mul>(reduce_op<T, Mul>(a[4], a[5]), reduce_op<T, Mul>(a[6], a[7])));
+			for (; i < n; i += 1)
+				r = reduce_op<T, Mul>(r, p[i]);
+			return r;
+		}
+
+#ifdef USEFUL_MATH_X86
+		inline bool cpu_has_avx() {
+			static const bool avx = __builtin_cpu_supports("avx");
+			return avx;
+		}
+
+		inline bool cpu_has_sse2() {
+			static const bool sse2 = __builtin_cpu_supports("sse2");
+			return sse2;
+		}
+
+		// Four vector accumulators at a time. Vec is the register type,
+		// and the Load/Op functions are the intrinsics for it; they're
+		// instantiated inside functions with the right target attribute.
+#define USEFUL_MATH_REDUCE_KERNEL(name, isa, T, Vec, lanes, set1, loadu, storeu, add, mul) \
+		template<bool Mul> \
+		__attribute__((target(isa))) inline T name(const T *p, std::size_t n) { \
+			const T id = Mul ? 1 : 0; \
+			Vec a0 = set1(id), a1 = a0, a2 = a0, a3 = a0; \
+			std::size_t i = 0; \
+			for (; i + 4 * lanes <= n; i += 4 * lanes) { \
+				if (Mul) { \
+					a0 = mul(a0, loadu(p + i)); \
+					a1 = mul(a1, loadu(p + i + lanes)); \
+					a2 = mul(a2, loadu(p + i + 2 * lanes)); \
+					a3 = mul(a3, loadu(p + i + 3 * lanes)); \
+				} else { \
+					a0 = add(a0, loadu(p + i)); \
+					a1 = add(a1, loadu(p + i + lanes)); \
+					a2 = add(a2, loadu(p + i + 2 * lanes)); \
+					a3 = add(a3, loadu(p + i + 3 * lanes)); \
+				} \
+			} \
+			a0 = Mul ? mul(mul(a0, a1), mul(a2, a3)) : add(add(a0, a1), add(a2, a3)); \
+			T v[lanes]; \
+			storeu(v, a0); \
+			T r = id; \
+			for (std::size_t j = 0; j < lanes; j += 1) \
+				r = reduce_op<T, Mul>(r, v[j]); \
+			for (; i < n; i += 1) \
+				r = reduce_op<T, Mul>(r, p[i]); \
+			return r; \
+		}
+
+		USEFUL_MATH_REDUCE_KERNEL(reduce_avx, "avx", double, __m256d, 4, _mm256_set1_pd,
+		                          _mm256_loadu_pd, _mm256_storeu_pd, _mm256_add_pd, _mm256_mul_pd)
+		USEFUL_MATH_REDUCE_KERNEL(reduce_avx, "avx", float, __m256, 8, _mm256_set1_ps,
+		                          _mm256_loadu_ps, _mm256_storeu_ps, _mm256_add_ps, _mm256_mul_ps)
+		USEFUL_MATH_REDUCE_KERNEL(reduce_sse2, "sse2", double, __m128d, 2, _mm_set1_pd,
+		                          _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd, _mm_mul_pd)
+		USEFUL_MATH_REDUCE_KERNEL(reduce_sse2, "sse2", float, __m128, 4, _mm_set1_ps,
+		                          _mm_loadu_ps, _mm_storeu_ps, _mm_add_ps, _mm_mul_ps)
+#undef USEFUL_MATH_REDUCE_KERNEL
+
+		template<class T>
+		using has_vector_kernel = std::integral_constant<bool,
+			std::is_same<T, double>::value || std::is_same<T, float>::value>;
+
+		// Picks the widest kernel the CPU supports.
+		template<class T, bool Mul>
+		T reduce_fast(const T *p, std::size_t n, std::true_type) {
+			if (cpu_has_avx())
+				return reduce_avx<Mul>(p, n);
+			if (cpu_has_sse2())
+				return reduce_sse2<Mul>(p, n);
+			return reduce_unrolled<T, Mul>(p, n);
+		}
+#else
+		template<class T>
+		using has_vector_kernel = std::false_type;
+#endif
+
+		template<class T, bool Mul>
+		T reduce_fast(const T *p, std::size_t n, std::false_type) {
+			return reduce_unrolled<T, Mul>(p, n);
+		}
+
+		template<class T, bool Mul>
+		T reduce_fast(const T *p, std::size_t n) {
+			return reduce_fast<T, Mul>(p, n, has_vector_kernel<T>());
+		}
+
+		template<class T>
+		T sum_pairwise(const T *p, std::size_t n) {
+			if (n <= 128)
+				return reduce_unrolled<T, false>(p, n);
+			std::size_t half = n / 2;
+			return sum_pairwise(p, half) + sum_pairwise(p + half, n - half);
+		}
+
+		template<class T>
+		T sum_kahan(const T *p, std::size_t n) {
+			T s = 0, c = 0;
+			for (std::size_t i = 0; i < n; i += 1) {
+				T y = p[i] - c;
+				T t = s + y;
+				c = (t - s) - y;
+				s = t;
+			}
+			return s;
+		}
+
+		template<class T>
+		T sum_contiguous(const T *p, std::size_t n, summation mode) {
+			if (std::is_floating_point<T>::value && mode == summation::pairwise)
+				return sum_pairwise(p, n);
+			if (std::is_floating_point<T>::value && mode == summation::kahan)
+				return sum_kahan(p, n);
+			return reduce_fast<T, false>(p, n);
+		}
+
+#ifndef USEFUL_DETAIL_MAKE_VOID
+#define USEFUL_DETAIL_MAKE_VOID
+		template<class... T>
+		struct make_void { using type = void; };
+#endif
+
+		// Containers with arithmetic elements in contiguous memory
+		template<class C, class = void>
+		struct is_contiguous_arithmetic : std::false_type {};
+		template<class C>
+		struct is_contiguous_arithmetic<C, typename make_void<decltype(std::declval<const C &>().data()),
+		                                                      decltype(std::declval<const C &>().size())>::type>
+			: std::integral_constant<bool,
+				std::is_arithmetic<typename C::value_type>::value
+				&& std::is_same<decltype(std::declval<const C &>().data()),
+				                const typename C::value_type *>::value> {};
+
+		// Iterators into a std::vector of arithmetic type
+		template<class It>
+		using is_vector_iterator = std::integral_constant<bool,
+			std::is_arithmetic<typename std::iterator_traits<It>::value_type>::value
+			&& !std::is_same<typename std::iterator_traits<It>::value_type, bool>::value
+			&& (std::is_same<It, typename std::vector<typename std::iterator_traits<It>::value_type>::iterator>::value
+			    || std::is_same<It, typename std::vector<typename std::iterator_traits<It>::value_type>::const_iterator>::value)>;
+
+		template<class InputIterator, class T = typename InputIterator::value_type>
+		T sum(InputIterator b, InputIterator e, std::true_type) {
+			return b == e ? 0 : sum_contiguous(&*b, e - b, summation::fast);
+		}
+		template<class InputIterator, class T = typename InputIterator::value_type>
+		T sum(InputIterator b, InputIterator e, std::false_type) {
+			return std::accumulate(b, e, static_cast<T>(0));
+		}
+
+		template<class InputIterator, class T = typename InputIterator::value_type>
+		T product(InputIterator b, InputIterator e, std::true_type) {
+			return b == e ? 1 : reduce_fast<T, true>(&*b, e - b);
+		}
+		template<class InputIterator, class T = typename InputIterator::value_type>
+		T product(InputIterator b, InputIterator e, std::false_type) {
+			return std::accumulate(b, e, static_cast<T>(1), std::multiplies<T>());
+		}
+
+		template<class Container>
+		typename Container::value_type sum_container(const Container &c, std::true_type) {
+			return sum_contiguous(c.data(), c.size(), summation::fast);
+		}
+		template<class Container>
+		typename Container::value_type sum_container(const Container &c, std::false_type) {
+			return sum(c.cbegin(), c.cend(), is_vector_iterator<typename Container::const_iterator>());
+		}
+
+		template<class Container>
+		typename Container::value_type product_container(const Container &c, std::true_type) {
+			return reduce_fast<typename Container::value_type, true>(c.data(), c.size());
+		}
+		template<class Container>
+		typename Container::value_type product_container(const Container &c, std::false_type) {
+			return product(c.cbegin(), c.cend(), is_vector_iterator<typename Container::const_iterator>());
+		}
+	};
+
+	/* Returns the sum of a range. Iterators into a vector of numbers
+	 * use the contiguous fast path. */
 	template<class InputIterator>
 	auto sum(InputIterator b, InputIterator e)
 		-> typename InputIterator::value_type {
-			using t = typename InputIterator::value_type;
-			return std::accumulate(b, e, static_cast<t>(0));
+			return detail::sum(b, e, detail::is_vector_iterator<InputIterator>());
 	}
-	
-	/* Returns the sum of a container */
+
+	/* Returns the sum of an array of numbers. See summation for the
+	 * accuracy and speed tradeoffs of the different modes. */
+	template<class T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+	T sum(const T *b, const T *e, summation mode = summation::fast) {
+		return detail::sum_contiguous(b, e - b, mode);
+	}
+
+	/* Returns the sum of a container. Containers of numbers with a
+	 * data() member, like vectors and arrays, use the contiguous fast
+	 * path. */
 	template<class Container>
 	auto sum(const Container &c) -> typename Container::value_type {
-		return sum(c.cbegin(), c.cend());
+		return detail::sum_container(c, detail::is_contiguous_arithmetic<Container>());
 	}
-	
-	/* Returns the product of a range */
+
+	template<class Container,
+	         typename = typename std::enable_if<detail::is_contiguous_arithmetic<Container>::value>::type>
+	auto sum(const Container &c, summation mode) -> typename Container::value_type {
+		return detail::sum_contiguous(c.data(), c.size(), mode);
+	}
+
+	/* Returns the product of a range. Iterators into a vector of numbers
+	 * use the contiguous fast path. */
 	template<class InputIterator>
 	auto product(InputIterator b, InputIterator e)
 		-> typename InputIterator::value_type {
-			using t = typename InputIterator::value_type;
-			return std::accumulate(b, e, static_cast<t>(1), std::multiplies<t>());
+			return detail::product(b, e, detail::is_vector_iterator<InputIterator>());
 	}
-	
+
+	/* Returns the product of an array of numbers. */
+	template<class T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+	T product(const T *b, const T *e) {
+		return detail::reduce_fast<T, true>(b, e - b);
+	}
+
 	/* Returns the product of a container */
 	template<class Container>
 	auto product(const Container &c) -> typename Container::value_type {
-		return product(c.cbegin(), c.cend());
+		return detail::product_container(c, detail::is_contiguous_arithmetic<Container>());
+	}
+
+	namespace detail {
+		// Parallel reductions cut the range into chunks of this many
+		// elements no matter how many threads there are, and combine the
+		// per-chunk results in chunk order, so the answer is the same
+		// bits with any thread count.
+		constexpr std::size_t reduce_chunk = 1 << 16;
+
+		// Returns reduce(begin, end) for each chunk of [0, n), in order.
+		// Threads take the next unclaimed chunk until they're all done.
+		template<class T, class Reduce>
+		std::vector<T> reduce_chunks(std::size_t n, unsigned threads, const T &fill, Reduce reduce) {
+			std::size_t chunks = (n + reduce_chunk - 1) / reduce_chunk;
+			std::vector<T> partials(chunks, fill);
+			if (threads == 0)
+				threads = default_threads();
+			if (threads > chunks)
+				threads = chunks;
+			std::atomic<std::size_t> next{0};
+			run_threads(threads, [&](unsigned) {
+					std::size_t c;
+					while ((c = next.fetch_add(1, std::memory_order_relaxed)) < chunks)
+						partials[c] = reduce(c * reduce_chunk, std::min(n, (c + 1) * reduce_chunk));
+				});
+			return partials;
+		}
+
+		template<class T>
+		T reduce_contiguous(const T *p, std::size_t n, summation, std::true_type) {
+			return reduce_fast<T, true>(p, n);
+		}
+		template<class T>
+		T reduce_contiguous(const T *p, std::size_t n, summation mode, std::false_type) {
+			return sum_contiguous(p, n, mode);
+		}
+
+		template<class T, bool Mul>
+		T parallel_contiguous(const T *p, std::size_t n, summation mode, unsigned threads) {
+			using op = std::integral_constant<bool, Mul>;
+			auto partials = reduce_chunks<T>(n, threads, Mul ? 1 : 0,
+			                                 [p, mode](std::size_t b, std::size_t e) {
+					return reduce_contiguous(p + b, e - b, mode, op());
+				});
+			return reduce_contiguous(partials.data(), partials.size(), mode, op());
+		}
+
+		template<class Iterator, class T, class BinaryOperation>
+		T parallel_reduce(Iterator first, Iterator last, T init, BinaryOperation op, unsigned threads,
+		                  std::random_access_iterator_tag) {
+			auto partials = reduce_chunks<T>(last - first, threads, init,
+			                                 [&](std::size_t b, std::size_t e) -> T {
+					T acc = first[b];
+					for (b += 1; b < e; b += 1)
+						acc = op(acc, first[b]);
+					return acc;
+				});
+			for (const auto &p : partials)
+				init = op(init, p);
+			return init;
+		}
+
+		template<class Iterator, class T, class BinaryOperation>
+		T parallel_reduce(Iterator first, Iterator last, T init, BinaryOperation op, unsigned,
+		                  std::input_iterator_tag) {
+			return std::accumulate(first, last, init, op);
+		}
+
+		template<class InputIterator, class T = typename InputIterator::value_type>
+		T parallel_sum(InputIterator b, InputIterator e, unsigned threads, std::true_type) {
+			return b == e ? 0 : parallel_contiguous<T, false>(&*b, e - b, summation::fast, threads);
+		}
+		template<class InputIterator, class T = typename InputIterator::value_type>
+		T parallel_sum(InputIterator b, InputIterator e, unsigned threads, std::false_type) {
+			return parallel_reduce(b, e, static_cast<T>(0), std::plus<T>(), threads,
+			                       typename std::iterator_traits<InputIterator>::iterator_category());
+		}
+
+		template<class InputIterator, class T = typename InputIterator::value_type>
+		T parallel_product(InputIterator b, InputIterator e, unsigned threads, std::true_type) {
+			return b == e ? 1 : parallel_contiguous<T, true>(&*b, e - b, summation::fast, threads);
+		}
+		template<class InputIterator, class T = typename InputIterator::value_type>
+		T parallel_product(InputIterator b, InputIterator e, unsigned threads, std::false_type) {
+			return parallel_reduce(b, e, static_cast<T>(1), std::multiplies<T>(), threads,
+			                       typename std::iterator_traits<InputIterator>::iterator_category());
+		}
+
+		template<class Container>
+		typename Container::value_type parallel_sum_container(const Container &c, unsigned threads, std::true_type) {
+			return parallel_contiguous<typename Container::value_type, false>(c.data(), c.size(), summation::fast, threads);
+		}
+		template<class Container>
+		typename Container::value_type parallel_sum_container(const Container &c, unsigned threads, std::false_type) {
+			return parallel_sum(c.cbegin(), c.cend(), threads,
+			                    is_vector_iterator<typename Container::const_iterator>());
+		}
+
+		template<class Container>
+		typename Container::value_type parallel_product_container(const Container &c, unsigned threads, std::true_type) {
+			return parallel_contiguous<typename Container::value_type, true>(c.data(), c.size(), summation::fast, threads);
+		}
+		template<class Container>
+		typename Container::value_type parallel_product_container(const Container &c, unsigned threads, std::false_type) {
+			return parallel_product(c.cbegin(), c.cend(), threads,
+			                        is_vector_iterator<typename Container::const_iterator>());
+		}
+	};
+
+	/* Reduces a range with op on multiple threads (default_threads() if
+	 * threads is 0), starting from init. op must be associative, and is
+	 * called concurrently. The range is cut into fixed size chunks that
+	 * are each reduced left to right and then combined in order, so
+	 * results don't depend on the thread count, though with floating
+	 * point they can differ from std::accumulate. Iterators that aren't
+	 * random access are reduced serially. */
+	template<class Iterator, class T, class BinaryOperation>
+	T parallel_reduce(Iterator first, Iterator last, T init, BinaryOperation op, unsigned threads = 0) {
+		return detail::parallel_reduce(first, last, init, op, threads,
+		                               typename std::iterator_traits<Iterator>::iterator_category());
+	}
+
+	template<class Container, class T, class BinaryOperation>
+	T parallel_reduce(const Container &c, T init, BinaryOperation op, unsigned threads = 0) {
+		return parallel_reduce(c.cbegin(), c.cend(), init, op, threads);
+	}
+
+	/* Returns the sum of a range, computed on multiple threads. See
+	 * parallel_reduce for how results stay the same with any number of
+	 * threads; contiguous ranges of numbers also use sum()'s fast path on
+	 * each chunk. */
+	template<class InputIterator>
+	auto parallel_sum(InputIterator b, InputIterator e, unsigned threads = 0)
+		-> typename InputIterator::value_type {
+			return detail::parallel_sum(b, e, threads, detail::is_vector_iterator<InputIterator>());
+	}
+
+	template<class T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+	T parallel_sum(const T *b, const T *e, unsigned threads = 0) {
+		return detail::parallel_contiguous<T, false>(b, e - b, summation::fast, threads);
+	}
+
+	template<class T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+	T parallel_sum(const T *b, const T *e, summation mode, unsigned threads = 0) {
+		return detail::parallel_contiguous<T, false>(b, e - b, mode, threads);
+	}
+
+	template<class Container>
+	auto parallel_sum(const Container &c, unsigned threads = 0) -> typename Container::value_type {
+		return detail::parallel_sum_container(c, threads, detail::is_contiguous_arithmetic<Container>());
+	}
+
+	template<class Container,
+	         typename = typename std::enable_if<detail::is_contiguous_arithmetic<Container>::value>::type>
+	auto parallel_sum(const Container &c, summation mode, unsigned threads = 0)
+		-> typename Container::value_type {
+			using t = typename Container::value_type;
+			return detail::parallel_contiguous<t, false>(c.data(), c.size(), mode, threads);
+	}
+
+	/* Returns the product of a range, computed on multiple threads. */
+	template<class InputIterator>
+	auto parallel_product(InputIterator b, InputIterator e, unsigned threads = 0)
+		-> typename InputIterator::value_type {
+			return detail::parallel_product(b, e, threads, detail::is_vector_iterator<InputIterator>());
+	}
+
+	template<class T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+	T parallel_product(const T *b, const T *e, unsigned threads = 0) {
+		return detail::parallel_contiguous<T, true>(b, e - b, summation::fast, threads);
+	}
+
+	template<class Container>
+	auto parallel_product(const Container &c, unsigned threads = 0) -> typename Container::value_type {
+		return detail::parallel_product_container(c, threads, detail::is_contiguous_arithmetic<Container>());
 	}
 	
 };
@@ -81,6 +81,7 @@ namespace useful {
   private:
     std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
   public:
+    spin_lock() = default;
     spin_lock(const spin_lock &) = delete;
     spin_lock(const spin_lock &&) = delete;
     spin_lock& operator=(const spin_lock &) = delete;
@@ -106,6 +107,7 @@ namespace useful {
     std::atomic<itype> current_ticket{0};
     std::atomic<itype> next_ticket{0};
   public:
+    ticket_lock() = default;
     ticket_lock(const ticket_lock &) = delete;
     ticket_lock(const ticket_lock &&) = delete;
     ticket_lock& operator=(const ticket_lock &) = delete;
@@ -27,11 +27,270 @@ SOFTWARE.
 
 #include <iterator>
 #include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <stdexcept>
 
 namespace useful {
 
+	/* Views are ranges that are cheap to copy because they refer to (or
+	 * lazily compute) elements stored somewhere else. Every adaptor here
+	 * is a view. Adaptors keep views by value and other containers by
+	 * reference, so they nest, and temporaries passed to them stay alive
+	 * for as long as the adaptor does:
+	 *
+	 * | for (auto i : take(drop(v, 2), 3)) {}
+	 * | for (auto i : v | drop(2) | take(3)) {}
+	 *
+	 * are equivalent, and walk v once with no intermediate containers.
+	 * A view's iterators refer back to it, so don't use them after the
+	 * view they came from is gone.
+	 *
+	 * Classes derived from view_base are views.
+	 */
+	struct view_base {};
+
+	template<typename T>
+	struct is_view
+		: std::is_base_of<view_base, typename std::remove_cv<typename std::remove_reference<T>::type>::type> {};
+
+	namespace detail {
+		template<typename Range>
+		using iterator_t = decltype(std::declval<Range &>().begin());
+
+		template<typename Iterator>
+		using category_t = typename std::iterator_traits<Iterator>::iterator_category;
+
+		// The weaker of two iterator categories
+		template<typename A, typename B>
+		using weaker_category_t = typename std::conditional<std::is_base_of<B, A>::value, B, A>::type;
+
+		template<typename Iterator>
+		constexpr bool is_random_access =
+			std::is_base_of<std::random_access_iterator_tag, category_t<Iterator>>::value;
+
+		template<typename Range, typename = void>
+		struct has_size : std::false_type {};
+		template<typename Range>
+		struct has_size<Range, std::void_t<decltype(std::declval<const Range &>().size())>>
+			: std::true_type {};
+
+		// The size() of a range, or the distance from begin to end if
+		// it doesn't have one.
+		template<typename Range>
+		std::size_t range_size(const Range &r) {
+			if constexpr (has_size<Range>::value)
+				return r.size();
+			else
+				return std::distance(std::begin(r), std::end(r));
+		}
+
+		// Advances it by up to n steps without passing end, and returns
+		// how many steps were left over.
+		template<typename Iterator>
+		typename std::iterator_traits<Iterator>::difference_type
+		advance_bounded(Iterator &it, typename std::iterator_traits<Iterator>::difference_type n,
+		                const Iterator &end) {
+			if constexpr (is_random_access<Iterator>) {
+				auto m = std::min(n, end - it);
+				it += m;
+				return n - m;
+			} else {
+				for (; n > 0 && it != end; n -= 1)
+					++it;
+				return n;
+			}
+		}
+
+		// Adaptors keep views by value and anything else by reference
+		template<typename Container>
+		using stored_t = typename std::conditional<is_view<Container>::value,
+			typename std::remove_const<Container>::type, Container &>::type;
+
+		// Returns it advanced by up to n steps, stopping at end
+		template<typename Iterator>
+		Iterator bounded_next(Iterator it, typename std::iterator_traits<Iterator>::difference_type n,
+		                      const Iterator &end) {
+			advance_bounded(it, n, end);
+			return it;
+		}
+
+		// A negative count of elements counts back from the end
+		template<typename Range, typename Difference>
+		Difference from_end(const Range &r, Difference n) {
+			if (n < 0)
+				n = std::max<Difference>(0, static_cast<Difference>(range_size(r)) + n);
+			return n;
+		}
+
+		// An iterator that's found the first time it's needed. Adaptors
+		// keep these mutable, since filling one in doesn't change what
+		// the adaptor refers to. Copies start out empty, because an
+		// adaptor that keeps a view by value has a new view after it's
+		// copied.
+		template<typename Iterator>
+		class iterator_cache {
+		private:
+			Iterator it{};
+			bool found = false;
+
+		public:
+			iterator_cache() = default;
+			iterator_cache(const iterator_cache &) noexcept {}
+			iterator_cache &operator=(const iterator_cache &) noexcept { found = false; return *this; }
+
+			template<typename Find>
+			const Iterator &get(Find find) {
+				if (!found) {
+					it = find();
+					found = true;
+				}
+				return it;
+			}
+		};
+
+		// Fills in the rest of an iterator's operators from the ++, --,
+		// +=, -, == and * it defines. Like any member of a template, each
+		// only needs the underlying iterator to support it if it's used.
+		template<typename Derived, typename Difference>
+		class iterator_ops {
+		private:
+			Derived &self() noexcept { return static_cast<Derived &>(*this); }
+			const Derived &self() const noexcept { return static_cast<const Derived &>(*this); }
+
+		public:
+			Derived operator++(int) { Derived t = self(); ++self(); return t; }
+			Derived operator--(int) { Derived t = self(); --self(); return t; }
+			Derived &operator-=(Difference n) { return self() += -n; }
+			friend Derived operator+(Derived a, Difference n) { return a += n; }
+			friend Derived operator+(Difference n, Derived a) { return a += n; }
+			friend Derived operator-(Derived a, Difference n) { return a -= n; }
+			decltype(auto) operator[](Difference n) const { return *(self() + n); }
+			friend bool operator!=(const Derived &a, const Derived &b) { return !(a == b); }
+			friend bool operator<(const Derived &a, const Derived &b) { return a - b < 0; }
+			friend bool operator>(const Derived &a, const Derived &b) { return b < a; }
+			friend bool operator<=(const Derived &a, const Derived &b) { return !(b < a); }
+			friend bool operator>=(const Derived &a, const Derived &b) { return !(a < b); }
+		};
+	};
+
+	/* A base for views that provides the members that can be worked out
+	 * from begin() and end(). Derived is the view class itself. */
+	template<typename Derived>
+	class view_interface : public view_base {
+	private:
+		const Derived &self() const noexcept { return static_cast<const Derived &>(*this); }
+
+	public:
+		auto cbegin(void) const { return self().begin(); }
+		auto cend(void) const { return self().end(); }
+
+		// Linear time unless the iterators are random access
+		std::size_t size(void) const {
+			return std::distance(self().begin(), self().end());
+		}
+
+		bool empty(void) const { return !(self().begin() != self().end()); }
+		explicit operator bool(void) const { return !empty(); }
+
+		decltype(auto) front(void) const { return *self().begin(); }
+		decltype(auto) back(void) const { return *std::prev(self().end()); }
+		decltype(auto) operator[](std::ptrdiff_t i) const { return self().begin()[i]; }
+	};
+
+	/* A view of every element of a container it refers to. */
+	template<typename Container>
+	class ref_view : public view_interface<ref_view<Container>> {
+	public:
+		using container_type = Container;
+		using iterator = decltype(std::begin(std::declval<Container &>()));
+		using const_iterator = iterator;
+		using value_type = typename std::iterator_traits<iterator>::value_type;
+		using difference_type = typename std::iterator_traits<iterator>::difference_type;
+		using size_type = std::size_t;
+
+	private:
+		container_type *c;
+
+	public:
+		explicit ref_view(container_type &c_) noexcept : c(&c_) {}
+
+		size_type size(void) const { return detail::range_size(*c); }
+
+		iterator begin(void) const { return std::begin(*c); }
+		iterator end(void) const { return std::end(*c); }
+	};
+
+	/* A view that owns a container moved into it, so adaptors can be
+	 * used on temporaries. It can be moved but not copied. */
+	template<typename Container>
+	class owning_view : public view_interface<owning_view<Container>> {
+	public:
+		using container_type = Container;
+		using iterator = typename container_type::iterator;
+		using const_iterator = typename container_type::const_iterator;
+		using value_type = typename container_type::value_type;
+		using difference_type = typename container_type::difference_type;
+		using size_type = std::size_t;
+
+	private:
+		container_type c;
+
+	public:
+		explicit owning_view(container_type &&c_) : c(std::move(c_)) {}
+		owning_view(owning_view &&) = default;
+		owning_view &operator=(owning_view &&) = default;
+
+		size_type size(void) const { return detail::range_size(c); }
+
+		iterator begin(void) { return c.begin(); }
+		const_iterator begin(void) const { return c.begin(); }
+		const_iterator cbegin(void) const { return c.begin(); }
+
+		iterator end(void) { return c.end(); }
+		const_iterator end(void) const { return c.end(); }
+		const_iterator cend(void) const { return c.end(); }
+	};
+
+	/* Returns r if it's a view, a ref_view of it if it's some other
+	 * lvalue, and an owning_view of it if it's some other rvalue. */
+	template<typename Range>
+	auto all(Range &&r) {
+		using plain = typename std::remove_cv<typename std::remove_reference<Range>::type>::type;
+		if constexpr (is_view<Range>::value)
+			return plain(std::forward<Range>(r));
+		else if constexpr (std::is_lvalue_reference<Range>::value)
+			return ref_view<typename std::remove_reference<Range>::type>(r);
+		else
+			return owning_view<plain>(std::move(r));
+	}
+
+	template<typename Range>
+	using all_t = decltype(all(std::declval<Range>()));
+
+	/* What the one-argument forms of the adaptor functions return, so
+	 * they can be chained with |. r | adaptor(args) is adaptor(r, args). */
+	template<typename Function>
+	struct pipe_adaptor {
+		Function f;
+	};
+
+	template<typename Function>
+	pipe_adaptor<Function> make_pipe_adaptor(Function f) {
+		return pipe_adaptor<Function>{std::move(f)};
+	}
+
+	template<typename Range, typename Function>
+	auto operator|(Range &&r, const pipe_adaptor<Function> &p) -> decltype(p.f(std::forward<Range>(r))) {
+		return p.f(std::forward<Range>(r));
+	}
+
+
 	/* Adaptors for range-based for loops to iterate over a container in reverse
-	 * order. Requires a container to provide rbegin() and rend().
+	 * order. Requires a container with bidirectional iterators.
 	 * const_reverse_adaptor is for immutable containers, and reverse_adaptor for
 	 * mutable ones. The rev() function automatically picks the right one to use
 	 * based on the const-ness of its argument.
@@ -44,55 +303,57 @@ namespace useful {
 	 * are equivalent.
 	 */
 	template<typename Container>
-	class const_reverse_adaptor {
+	class const_reverse_adaptor : public view_interface<const_reverse_adaptor<Container>> {
 	public:
 		using container_type = typename std::add_const<Container>::type;
-		using const_iterator = typename container_type::const_reverse_iterator;
+		using const_iterator = std::reverse_iterator<typename container_type::const_iterator>;
+		using iterator = const_iterator;
 		using value_type = typename container_type::value_type;
 		using difference_type = typename container_type::difference_type;
 		using size_type = typename container_type::size_type;
 		
 	private:
-		container_type &c;
+		detail::stored_t<container_type> c;
 	
 	public:
 		explicit const_reverse_adaptor(container_type &c_) : c(c_) {}
 	
 		size_type size(void) const { return c.size(); }
 		
-		const_iterator begin(void) const noexcept { return c.rbegin(); }
-		const_iterator cbegin(void) const noexcept { return c.rbegin(); }
+		const_iterator begin(void) const noexcept { return const_iterator(c.cend()); }
+		const_iterator cbegin(void) const noexcept { return const_iterator(c.cend()); }
 		
-		const_iterator end(void) const noexcept { return c.rend(); }
-		const_iterator cend(void) const noexcept { return c.rend(); }
+		const_iterator end(void) const noexcept { return const_iterator(c.cbegin()); }
+		const_iterator cend(void) const noexcept { return const_iterator(c.cbegin()); }
 	};
 	
 	template<typename Container,
 		typename = typename std::enable_if<!std::is_const<Container>::value>::type> 
-	class reverse_adaptor {
+	class reverse_adaptor : public view_interface<reverse_adaptor<Container>> {
 	public:
 		using container_type = Container;
-		using iterator = typename container_type::reverse_iterator;
-		using const_iterator = typename container_type::const_reverse_iterator;
+		using iterator = std::reverse_iterator<typename container_type::iterator>;
+		using const_iterator = std::reverse_iterator<typename container_type::const_iterator>;
 		using value_type = typename container_type::value_type;
 		using difference_type = typename container_type::difference_type;
 		using size_type = typename container_type::size_type;
 		
 	private:
-		container_type &c;
+		detail::stored_t<container_type> c;
 	
 	public:
 		explicit reverse_adaptor(container_type &c_) : c(c_) {}
+		explicit reverse_adaptor(container_type &&c_) : c(std::move(c_)) {}
 
 		size_type size(void) const { return c.size(); }
 				
-		iterator begin(void) noexcept { return c.rbegin(); }
-		const_iterator begin(void) const noexcept { return c.rbegin(); }
-		const_iterator cbegin(void) const noexcept { return c.rbegin(); }
+		iterator begin(void) noexcept { return iterator(c.end()); }
+		const_iterator begin(void) const noexcept { return const_iterator(c.cend()); }
+		const_iterator cbegin(void) const noexcept { return const_iterator(c.cend()); }
 		
-		iterator end(void) noexcept { return c.rend(); }
-		const_iterator end(void) const noexcept { return c.rend(); }
-		const_iterator cend(void) const noexcept { return c.rend(); }
+		iterator end(void) noexcept { return iterator(c.begin()); }
+		const_iterator end(void) const noexcept { return const_iterator(c.cbegin()); }
+		const_iterator cend(void) const noexcept { return const_iterator(c.cbegin()); }
 	};
 	
 	template<typename Container>
@@ -110,34 +371,61 @@ namespace useful {
 		return reverse_adaptor<Container>(c);
 	} 
 
+	// Temporaries are kept in the adaptor
+	template<typename Container,
+		typename = typename std::enable_if<!std::is_reference<Container>::value>::type>
+	reverse_adaptor<all_t<Container>> rev(Container &&c) {
+		return reverse_adaptor<all_t<Container>>(all(std::move(c)));
+	}
+
+	inline auto rev(void) {
+		return make_pipe_adaptor([](auto &&c) { return rev(std::forward<decltype(c)>(c)); });
+	}
+
 	/* Adaptors to iterate over all but the first N elements of a container.
 	 *  for (auto i : drop(foo, 5)) skips the first five elements.
 	 * If N is negative, drops all but the last abs(N) elements
 	 *  for (auto i : drop(foo, -2)) iterates over only the last 2 elements.
+	 *
+	 * The drop and take adaptors find the iterator N elements in the first
+	 * time they need it and then remember it, so begin() and end() are
+	 * constant time after that even for lists. Anything that invalidates
+	 * that iterator (or, for a negative N, changes the container's size)
+	 * invalidates the adaptor; make a new one. Copies of an adaptor find
+	 * it again. Like a container, an adaptor can't be used from several
+	 * threads at once unless begin() and end() have already been called.
+	 * Works with containers like std::forward_list that don't have size(),
+	 * but then size() and negative N take linear time.
 	*/
 	template<typename Container>
-	class const_drop_adaptor {
+	class const_drop_adaptor : public view_interface<const_drop_adaptor<Container>> {
 	public:
 		using container_type = typename std::add_const<Container>::type;
 		using const_iterator = typename container_type::const_iterator;
+		using iterator = const_iterator;
 		using difference_type = typename container_type::difference_type;
 		using value_type = typename container_type::value_type;
 		using size_type = typename container_type::size_type;
 		
 	private:
-		container_type &c;
+		detail::stored_t<container_type> c;
 		difference_type n;
+		mutable detail::iterator_cache<const_iterator> first;
 		
 	public:
-		const_drop_adaptor(container_type &c_, difference_type n_) : c(c_), n(n_) {
-				if (n < 0)
-					n = c.size() + n;
-		}
+		const_drop_adaptor(container_type &c_, difference_type n_) : c(c_), n(detail::from_end(c_, n_)) {}
 
-		size_type size(void) const { return c.size(); }
+		size_type size(void) const {
+			if constexpr (detail::has_size<container_type>::value)
+				return c.size() - std::min<size_type>(n, c.size());
+			else
+				return std::distance(cbegin(), cend());
+		}
 		
 		const_iterator begin(void) const noexcept { return cbegin(); }
-		const_iterator cbegin(void) const noexcept { return std::next(c.cbegin(), n); }
+		const_iterator cbegin(void) const noexcept {
+			return first.get([this] { return detail::bounded_next(c.cbegin(), n, c.cend()); });
+		}
 
 		const_iterator end(void) const noexcept { return c.cend(); }
 		const_iterator cend(void) const noexcept { return c.cend(); }
@@ -145,7 +433,7 @@ namespace useful {
 	
 	template<typename Container,
 		typename = typename std::enable_if<!std::is_const<Container>::value>::type>
-	class drop_adaptor {
+	class drop_adaptor : public view_interface<drop_adaptor<Container>> {
 	public:
 		using container_type = Container;
 		using iterator = typename container_type::iterator;
@@ -155,20 +443,29 @@ namespace useful {
 		using size_type = typename container_type::size_type;
 	
 	private:
-		container_type &c;
+		detail::stored_t<container_type> c;
 		difference_type n;
+		mutable detail::iterator_cache<iterator> first;
+		mutable detail::iterator_cache<const_iterator> cfirst;
 	
 	public:
-		drop_adaptor(container_type &c_, difference_type n_) : c(c_), n(n_) {
-				if (n < 0)
-					n = c.size() + n;
-		}
+		drop_adaptor(container_type &c_, difference_type n_) : c(c_), n(detail::from_end(c_, n_)) {}
+		drop_adaptor(container_type &&c_, difference_type n_) : c(std::move(c_)), n(detail::from_end(c, n_)) {}
 
-		size_type size(void) const { return c.size(); }
+		size_type size(void) const {
+			if constexpr (detail::has_size<container_type>::value)
+				return c.size() - std::min<size_type>(n, c.size());
+			else
+				return std::distance(cbegin(), cend());
+		}
 		
-		iterator begin(void) noexcept { return std::next(c.begin(), n); }
+		iterator begin(void) noexcept {
+			return first.get([this] { return detail::bounded_next(c.begin(), n, c.end()); });
+		}
 		const_iterator begin(void) const noexcept { return cbegin(); }
-		const_iterator cbegin(void) const noexcept { return std::next(c.cbegin(), n); }
+		const_iterator cbegin(void) const noexcept {
+			return cfirst.get([this] { return detail::bounded_next(c.cbegin(), n, c.cend()); });
+		}
 		
 		iterator end(void) noexcept { return c.end(); }
 		const_iterator end(void) const noexcept { return c.cend(); }
@@ -192,43 +489,61 @@ namespace useful {
 	drop(Container &c, typename Container::difference_type n) {
 		return drop_adaptor<Container>(c, n);
 	} 
+
+	template<typename Container,
+		typename = typename std::enable_if<!std::is_reference<Container>::value>::type>
+	drop_adaptor<all_t<Container>>
+	drop(Container &&c, typename Container::difference_type n) {
+		return drop_adaptor<all_t<Container>>(all(std::move(c)), n);
+	}
+
+	inline auto drop(std::ptrdiff_t n) {
+		return make_pipe_adaptor([n](auto &&c) { return drop(std::forward<decltype(c)>(c), n); });
+	}
 	
 	/* Adaptors to iterate over just the first N elements of a container.
 	 *  for (auto i : take(foo, 5)) stops after five elements.
 	 * If N is negative, stops abs(N) elements from the end. So
 	 *  for (auto i : take(foo, -1)) iterates over all but the last element.
+	 * See drop for how the end is found and when it's invalidated.
 	*/
 	template<typename Container>
-	class const_take_adaptor {
+	class const_take_adaptor : public view_interface<const_take_adaptor<Container>> {
 	public:
 		using container_type = typename std::add_const<Container>::type;
 		using const_iterator = typename container_type::const_iterator;
+		using iterator = const_iterator;
 		using difference_type = typename container_type::difference_type;
 		using value_type = typename container_type::value_type;
 		using size_type = typename container_type::size_type;
 		
 	private:
-		container_type &c;
+		detail::stored_t<container_type> c;
 		difference_type n;
+		mutable detail::iterator_cache<const_iterator> last;
 		
 	public:
-		const_take_adaptor(container_type &c_, difference_type n_) : c(c_), n(n_) { 
-				if (n < 0)
-					n = c.size() + n;
-		}
+		const_take_adaptor(container_type &c_, difference_type n_) : c(c_), n(detail::from_end(c_, n_)) {}
 
-		size_type size(void) const { return c.size(); }
+		size_type size(void) const {
+			if constexpr (detail::has_size<container_type>::value)
+				return std::min<size_type>(n, c.size());
+			else
+				return std::distance(cbegin(), cend());
+		}
 		
 		const_iterator begin(void) const noexcept { return c.cbegin(); }
 		const_iterator cbegin(void) const noexcept { return c.cbegin(); }
 		
 		const_iterator end(void) const noexcept { return cend(); }
-		const_iterator cend(void) const noexcept { return std::next(c.cbegin(), n); }
+		const_iterator cend(void) const noexcept {
+			return last.get([this] { return detail::bounded_next(c.cbegin(), n, c.cend()); });
+		}
 	};
 	
 	template<typename Container,
 		typename = typename std::enable_if<!std::is_const<Container>::value>::type>
-	class take_adaptor {
+	class take_adaptor : public view_interface<take_adaptor<Container>> {
 	public:
 		using container_type = Container;
 		using iterator = typename container_type::iterator;
@@ -238,24 +553,33 @@ namespace useful {
 		using size_type = typename container_type::size_type;
 		
 	private:
-		container_type &c;
+		detail::stored_t<container_type> c;
 		difference_type n;
+		mutable detail::iterator_cache<iterator> last;
+		mutable detail::iterator_cache<const_iterator> clast;
 	
 	public:
-		take_adaptor(container_type &c_, difference_type n_) : c(c_), n(n_) {
-				if (n < 0)
-					n = c.size() + n;
-		}
+		take_adaptor(container_type &c_, difference_type n_) : c(c_), n(detail::from_end(c_, n_)) {}
+		take_adaptor(container_type &&c_, difference_type n_) : c(std::move(c_)), n(detail::from_end(c, n_)) {}
 
-		size_type size(void) const { return c.size(); }
+		size_type size(void) const {
+			if constexpr (detail::has_size<container_type>::value)
+				return std::min<size_type>(n, c.size());
+			else
+				return std::distance(cbegin(), cend());
+		}
 		
 		iterator begin(void) noexcept { return c.begin(); }
 		const_iterator begin(void) const noexcept { return c.cbegin(); }
 		const_iterator cbegin(void) const noexcept { return c.cbegin(); }
 		
-		iterator end(void) noexcept { return std::next(c.begin(), n); }
+		iterator end(void) noexcept {
+			return last.get([this] { return detail::bounded_next(c.begin(), n, c.end()); });
+		}
 		const_iterator end(void) const noexcept { return cend(); }
-		const_iterator cend(void) const noexcept { return std::next(c.cbegin(), n); }
+		const_iterator cend(void) const noexcept {
+			return clast.get([this] { return detail::bounded_next(c.cbegin(), n, c.cend()); });
+		}
 	};
 
  template<class Container>
@@ -275,6 +599,491 @@ namespace useful {
  take(Container &c, typename Container::difference_type n) {
  	 return take_adaptor<Container>(c, n);
  } 
+
+	template<class Container,
+		typename = typename std::enable_if<!std::is_reference<Container>::value>::type>
+	take_adaptor<all_t<Container>>
+	take(Container &&c, typename Container::difference_type n) {
+		return take_adaptor<all_t<Container>>(all(std::move(c)), n);
+	}
+
+	inline auto take(std::ptrdiff_t n) {
+		return make_pipe_adaptor([n](auto &&c) { return take(std::forward<decltype(c)>(c), n); });
+	}
+
+	/* A view of the elements from one iterator up to another. */
+	template<typename Iterator>
+	class subrange : public view_interface<subrange<Iterator>> {
+	public:
+		using iterator = Iterator;
+		using const_iterator = Iterator;
+		using value_type = typename std::iterator_traits<Iterator>::value_type;
+		using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+		using size_type = std::size_t;
+
+	private:
+		Iterator b, e;
+
+	public:
+		subrange() = default;
+		subrange(Iterator b_, Iterator e_) : b(b_), e(e_) {}
+
+		iterator begin(void) const { return b; }
+		iterator end(void) const { return e; }
+	};
+
+	/* A view of the results of calling f on each element of a range.
+	 *  for (auto i : transform(v, [](int x) { return x * x; }))
+	 * f is called every time an element is looked at. */
+	template<typename View, typename Function>
+	class transform_view : public view_interface<transform_view<View, Function>> {
+	private:
+		using base_iterator = detail::iterator_t<const View>;
+
+	public:
+		class iterator : public detail::iterator_ops<iterator,
+			typename std::iterator_traits<base_iterator>::difference_type> {
+		private:
+			base_iterator it;
+			const Function *f = nullptr;
+
+		public:
+			using iterator_category = detail::category_t<base_iterator>;
+			using reference = decltype((*f)(*it));
+			using value_type = typename std::decay<reference>::type;
+			using difference_type = typename std::iterator_traits<base_iterator>::difference_type;
+			using pointer = void;
+
+			iterator() = default;
+			iterator(base_iterator it_, const Function *f_) : it(it_), f(f_) {}
+
+			reference operator*() const { return (*f)(*it); }
+			iterator &operator++() { ++it; return *this; }
+			iterator &operator--() { --it; return *this; }
+			iterator &operator+=(difference_type n) { it += n; return *this; }
+			using detail::iterator_ops<iterator, difference_type>::operator++;
+			using detail::iterator_ops<iterator, difference_type>::operator--;
+			friend difference_type operator-(const iterator &a, const iterator &b) { return a.it - b.it; }
+			friend bool operator==(const iterator &a, const iterator &b) { return a.it == b.it; }
+		};
+		using const_iterator = iterator;
+		using value_type = typename iterator::value_type;
+		using difference_type = typename iterator::difference_type;
+		using size_type = std::size_t;
+
+	private:
+		View base;
+		Function f;
+
+	public:
+		transform_view(View base_, Function f_) : base(std::move(base_)), f(std::move(f_)) {}
+
+		size_type size(void) const { return detail::range_size(base); }
+
+		iterator begin(void) const { return iterator(base.begin(), &f); }
+		iterator end(void) const { return iterator(base.end(), &f); }
+	};
+
+	template<typename Range, typename Function>
+	transform_view<all_t<Range>, Function> transform(Range &&r, Function f) {
+		return transform_view<all_t<Range>, Function>(all(std::forward<Range>(r)), std::move(f));
+	}
+
+	template<typename Function>
+	auto transform(Function f) {
+		return make_pipe_adaptor([f](auto &&r) { return transform(std::forward<decltype(r)>(r), f); });
+	}
+
+	/* A view of just the elements of a range that pred returns true for.
+	 * Iterators are at most forward iterators, and finding begin() and
+	 * size() take linear time. */
+	template<typename View, typename Predicate>
+	class filter_view : public view_interface<filter_view<View, Predicate>> {
+	private:
+		using base_iterator = detail::iterator_t<const View>;
+
+	public:
+		class iterator : public detail::iterator_ops<iterator,
+			typename std::iterator_traits<base_iterator>::difference_type> {
+		private:
+			base_iterator it, last;
+			const Predicate *pred = nullptr;
+
+			void satisfy() {
+				while (it != last && !(*pred)(*it))
+					++it;
+			}
+
+		public:
+			using iterator_category =
+				detail::weaker_category_t<detail::category_t<base_iterator>, std::forward_iterator_tag>;
+			using reference = typename std::iterator_traits<base_iterator>::reference;
+			using value_type = typename std::iterator_traits<base_iterator>::value_type;
+			using difference_type = typename std::iterator_traits<base_iterator>::difference_type;
+			using pointer = typename std::iterator_traits<base_iterator>::pointer;
+
+			iterator() = default;
+			iterator(base_iterator it_, base_iterator last_, const Predicate *pred_)
+				: it(it_), last(last_), pred(pred_) { satisfy(); }
+
+			reference operator*() const { return *it; }
+			iterator &operator++() { ++it; satisfy(); return *this; }
+			using detail::iterator_ops<iterator, difference_type>::operator++;
+			friend bool operator==(const iterator &a, const iterator &b) { return a.it == b.it; }
+		};
+		using const_iterator = iterator;
+		using value_type = typename iterator::value_type;
+		using difference_type = typename iterator::difference_type;
+		using size_type = std::size_t;
+
+	private:
+		View base;
+		Predicate pred;
+
+	public:
+		filter_view(View base_, Predicate pred_) : base(std::move(base_)), pred(std::move(pred_)) {}
+
+		iterator begin(void) const { return iterator(base.begin(), base.end(), &pred); }
+		iterator end(void) const { return iterator(base.end(), base.end(), &pred); }
+	};
+
+	template<typename Range, typename Predicate>
+	filter_view<all_t<Range>, Predicate> filter(Range &&r, Predicate pred) {
+		return filter_view<all_t<Range>, Predicate>(all(std::forward<Range>(r)), std::move(pred));
+	}
+
+	template<typename Predicate>
+	auto filter(Predicate pred) {
+		return make_pipe_adaptor([pred](auto &&r) { return filter(std::forward<decltype(r)>(r), pred); });
+	}
+
+	namespace detail {
+		// Steps n elements at a time through a range, like C++23's
+		// stride_view. missing is how far short of a whole step the
+		// last one fell at the end, so the iterator can step back.
+		// With Chunk, each element is the subrange up to the next step.
+		template<typename Iterator, bool Chunk>
+		class step_iterator : public iterator_ops<step_iterator<Iterator, Chunk>,
+			typename std::iterator_traits<Iterator>::difference_type> {
+		public:
+			using iterator_category = category_t<Iterator>;
+			using reference = typename std::conditional<Chunk, subrange<Iterator>,
+				typename std::iterator_traits<Iterator>::reference>::type;
+			using value_type = typename std::conditional<Chunk, subrange<Iterator>,
+				typename std::iterator_traits<Iterator>::value_type>::type;
+			using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+			using pointer = void;
+
+		private:
+			Iterator it, last;
+			difference_type n = 1, missing = 0;
+
+		public:
+			step_iterator() = default;
+			step_iterator(Iterator it_, Iterator last_, difference_type n_, difference_type missing_ = 0)
+				: it(it_), last(last_), n(n_), missing(missing_) {}
+
+			reference operator*() const {
+				if constexpr (Chunk) {
+					Iterator e = it;
+					advance_bounded(e, n, last);
+					return reference(it, e);
+				} else {
+					return *it;
+				}
+			}
+
+			step_iterator &operator++() { missing = advance_bounded(it, n, last); return *this; }
+			step_iterator &operator--() { std::advance(it, missing - n); missing = 0; return *this; }
+			step_iterator &operator+=(difference_type k) {
+				if (k > 0) {
+					missing = advance_bounded(it, n * k, last);
+				} else if (k < 0) {
+					it += n * k + missing;
+					missing = 0;
+				}
+				return *this;
+			}
+			using iterator_ops<step_iterator, difference_type>::operator++;
+			using iterator_ops<step_iterator, difference_type>::operator--;
+
+			friend difference_type operator-(const step_iterator &a, const step_iterator &b) {
+				difference_type d = (a.it - b.it) + a.missing - b.missing;
+				return d / a.n;
+			}
+			friend bool operator==(const step_iterator &a, const step_iterator &b) { return a.it == b.it; }
+		};
+
+		// The end of a stride or chunk view. Stepping back from it needs
+		// to know how far short of a whole step the last one fell, but
+		// working that out costs a walk over forward-only ranges, where
+		// it isn't needed anyway.
+		template<typename StepIterator, typename View>
+		StepIterator step_end(const View &base, typename StepIterator::difference_type n) {
+			typename StepIterator::difference_type missing = 0;
+			if constexpr (std::is_base_of<std::bidirectional_iterator_tag,
+			                              typename StepIterator::iterator_category>::value) {
+				auto len = static_cast<typename StepIterator::difference_type>(range_size(base));
+				missing = (n - len % n) % n;
+			}
+			return StepIterator(base.end(), base.end(), n, missing);
+		}
+	};
+
+	/* A view of every nth element of a range, starting with the first.
+	 * stride() throws std::invalid_argument if n isn't positive. */
+	template<typename View>
+	class stride_view : public view_interface<stride_view<View>> {
+	public:
+		using iterator = detail::step_iterator<detail::iterator_t<const View>, false>;
+		using const_iterator = iterator;
+		using value_type = typename iterator::value_type;
+		using difference_type = typename iterator::difference_type;
+		using size_type = std::size_t;
+
+	private:
+		View base;
+		difference_type n;
+
+	public:
+		stride_view(View base_, difference_type n_) : base(std::move(base_)), n(n_) {}
+
+		size_type size(void) const { return (detail::range_size(base) + n - 1) / n; }
+
+		iterator begin(void) const { return iterator(base.begin(), base.end(), n); }
+		iterator end(void) const { return detail::step_end<iterator>(base, n); }
+	};
+
+	template<typename Range>
+	stride_view<all_t<Range>> stride(Range &&r, std::ptrdiff_t n) {
+		if (n <= 0)
+			throw std::invalid_argument{"stride size must be positive"};
+		return stride_view<all_t<Range>>(all(std::forward<Range>(r)), n);
+	}
+
+	inline auto stride(std::ptrdiff_t n) {
+		if (n <= 0)
+			throw std::invalid_argument{"stride size must be positive"};
+		return make_pipe_adaptor([n](auto &&r) { return stride(std::forward<decltype(r)>(r), n); });
+	}
+
+	/* A view of a range split into consecutive subranges of n elements.
+	 * The last one is shorter if the size isn't a multiple of n.
+	 * chunk() throws std::invalid_argument if n isn't positive. */
+	template<typename View>
+	class chunk_view : public view_interface<chunk_view<View>> {
+	public:
+		using iterator = detail::step_iterator<detail::iterator_t<const View>, true>;
+		using const_iterator = iterator;
+		using value_type = typename iterator::value_type;
+		using difference_type = typename iterator::difference_type;
+		using size_type = std::size_t;
+
+	private:
+		View base;
+		difference_type n;
+
+	public:
+		chunk_view(View base_, difference_type n_) : base(std::move(base_)), n(n_) {}
+
+		size_type size(void) const { return (detail::range_size(base) + n - 1) / n; }
+
+		iterator begin(void) const { return iterator(base.begin(), base.end(), n); }
+		iterator end(void) const { return detail::step_end<iterator>(base, n); }
+	};
+
+	template<typename Range>
+	chunk_view<all_t<Range>> chunk(Range &&r, std::ptrdiff_t n) {
+		if (n <= 0)
+			throw std::invalid_argument{"chunk size must be positive"};
+		return chunk_view<all_t<Range>>(all(std::forward<Range>(r)), n);
+	}
+
+	inline auto chunk(std::ptrdiff_t n) {
+		if (n <= 0)
+			throw std::invalid_argument{"chunk size must be positive"};
+		return make_pipe_adaptor([n](auto &&r) { return chunk(std::forward<decltype(r)>(r), n); });
+	}
+
+	/* A view of tuples of the corresponding elements of several ranges,
+	 * as long as the shortest one.
+	 *  for (auto [a, b] : zip(v, w))
+	 * The tuples hold references, so assigning to a or b assigns to the
+	 * elements of v and w. */
+	template<typename... Views>
+	class zip_view : public view_interface<zip_view<Views...>> {
+	private:
+		using base_iterators = std::tuple<detail::iterator_t<const Views>...>;
+
+	public:
+		class iterator : public detail::iterator_ops<iterator, std::ptrdiff_t> {
+		private:
+			base_iterators its;
+
+		public:
+			using iterator_category = typename std::common_type<detail::category_t<detail::iterator_t<const Views>>...>::type;
+			using reference = std::tuple<typename std::iterator_traits<detail::iterator_t<const Views>>::reference...>;
+			using value_type = std::tuple<typename std::iterator_traits<detail::iterator_t<const Views>>::value_type...>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+
+			iterator() = default;
+			explicit iterator(base_iterators its_) : its(std::move(its_)) {}
+
+			reference operator*() const {
+				return std::apply([](const auto &... it) { return reference(*it...); }, its);
+			}
+			iterator &operator++() { std::apply([](auto &... it) { (++it, ...); }, its); return *this; }
+			iterator &operator--() { std::apply([](auto &... it) { (--it, ...); }, its); return *this; }
+			iterator &operator+=(difference_type n) { std::apply([n](auto &... it) { ((it += n), ...); }, its); return *this; }
+			using detail::iterator_ops<iterator, difference_type>::operator++;
+			using detail::iterator_ops<iterator, difference_type>::operator--;
+
+			// The closest any of the iterators are, so end() - begin() is
+			// the length of the shortest range.
+			friend difference_type operator-(const iterator &a, const iterator &b) {
+				return distance(a, b, std::index_sequence_for<Views...>());
+			}
+			// Equal if any of the iterators are, so iteration stops at the
+			// end of the shortest range.
+			friend bool operator==(const iterator &a, const iterator &b) {
+				return equal(a, b, std::index_sequence_for<Views...>());
+			}
+
+		private:
+			template<std::size_t... I>
+			static difference_type distance(const iterator &a, const iterator &b, std::index_sequence<I...>) {
+				difference_type ds[] = {static_cast<difference_type>(std::get<I>(a.its) - std::get<I>(b.its))...};
+				difference_type d = ds[0];
+				for (auto x : ds)
+					if (x < 0 ? x > d : x < d)
+						d = x;
+				return d;
+			}
+			template<std::size_t... I>
+			static bool equal(const iterator &a, const iterator &b, std::index_sequence<I...>) {
+				return (... || (std::get<I>(a.its) == std::get<I>(b.its)));
+			}
+		};
+		using const_iterator = iterator;
+		using value_type = typename iterator::value_type;
+		using difference_type = typename iterator::difference_type;
+		using size_type = std::size_t;
+
+	private:
+		std::tuple<Views...> bases;
+
+	public:
+		explicit zip_view(Views... bases_) : bases(std::move(bases_)...) {}
+
+		size_type size(void) const {
+			return std::apply([](const auto &... b) { return std::min({detail::range_size(b)...}); }, bases);
+		}
+
+		iterator begin(void) const {
+			return iterator(std::apply([](const auto &... b) { return base_iterators(b.begin()...); }, bases));
+		}
+		iterator end(void) const {
+			return iterator(std::apply([](const auto &... b) { return base_iterators(b.end()...); }, bases));
+		}
+	};
+
+	template<typename... Ranges>
+	zip_view<all_t<Ranges>...> zip(Ranges &&... rs) {
+		return zip_view<all_t<Ranges>...>(all(std::forward<Ranges>(rs))...);
+	}
+
+	/* A view of pairs of the position of each element of a range and the
+	 * element itself.
+	 *  for (auto [i, x] : enumerate(v)) */
+	template<typename View>
+	class enumerate_view : public view_interface<enumerate_view<View>> {
+	private:
+		using base_iterator = detail::iterator_t<const View>;
+
+	public:
+		class iterator : public detail::iterator_ops<iterator,
+			typename std::iterator_traits<base_iterator>::difference_type> {
+		private:
+			base_iterator it;
+			std::size_t i = 0;
+
+		public:
+			using iterator_category = detail::category_t<base_iterator>;
+			using reference = std::pair<std::size_t, typename std::iterator_traits<base_iterator>::reference>;
+			using value_type = std::pair<std::size_t, typename std::iterator_traits<base_iterator>::value_type>;
+			using difference_type = typename std::iterator_traits<base_iterator>::difference_type;
+			using pointer = void;
+
+			iterator() = default;
+			iterator(base_iterator it_, std::size_t i_) : it(it_), i(i_) {}
+
+			reference operator*() const { return reference(i, *it); }
+			iterator &operator++() { ++it; ++i; return *this; }
+			iterator &operator--() { --it; --i; return *this; }
+			iterator &operator+=(difference_type n) { it += n; i += n; return *this; }
+			using detail::iterator_ops<iterator, difference_type>::operator++;
+			using detail::iterator_ops<iterator, difference_type>::operator--;
+			friend difference_type operator-(const iterator &a, const iterator &b) { return a.it - b.it; }
+			friend bool operator==(const iterator &a, const iterator &b) { return a.it == b.it; }
+		};
+		using const_iterator = iterator;
+		using value_type = typename iterator::value_type;
+		using difference_type = typename iterator::difference_type;
+		using size_type = std::size_t;
+
+	private:
+		View base;
+
+	public:
+		explicit enumerate_view(View base_) : base(std::move(base_)) {}
+
+		size_type size(void) const { return detail::range_size(base); }
+
+		iterator begin(void) const { return iterator(base.begin(), 0); }
+		// Only the base iterator is compared, so the count doesn't matter
+		iterator end(void) const { return iterator(base.end(), 0); }
+	};
+
+	template<typename Range>
+	enumerate_view<all_t<Range>> enumerate(Range &&r) {
+		return enumerate_view<all_t<Range>>(all(std::forward<Range>(r)));
+	}
+
+	inline auto enumerate(void) {
+		return make_pipe_adaptor([](auto &&r) { return enumerate(std::forward<decltype(r)>(r)); });
+	}
+
+	/* Splits a container into k consecutive subranges whose sizes differ
+	 * by at most one, for handing to k worker threads. With random access
+	 * iterators it doesn't walk the container at all. Otherwise it takes
+	 * one pass to cut it, plus one to count it first if it has no size(),
+	 * like std::forward_list. Some of the subranges are empty if k is
+	 * more than the size.
+	 *
+	 * | auto parts = split_into(v, 4);
+	 * | run_threads(4, [&](unsigned t) { for (auto &x : parts[t]) ...; });
+	 */
+	template<typename Container>
+	std::vector<subrange<detail::iterator_t<Container>>> split_into(Container &c, std::size_t k) {
+		std::vector<subrange<detail::iterator_t<Container>>> parts;
+		if (k == 0)
+			return parts;
+		parts.reserve(k);
+		std::size_t n = detail::range_size(c);
+		auto it = c.begin();
+		for (std::size_t i = 0; i < k; i += 1) {
+			auto next = it;
+			std::advance(next, n / k + (i < n % k));
+			parts.emplace_back(it, next);
+			it = next;
+		}
+		return parts;
+	}
+
+	// The subranges would outlive a temporary
+	template<typename Container>
+	void split_into(const Container &&, std::size_t) = delete;
 };
 
 #endif
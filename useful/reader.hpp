@@ -0,0 +1,293 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 shawnw
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef USEFUL_READER_HPP
+#define USEFUL_READER_HPP
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <system_error>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Fast, allocation-free reading of text files as lines, delimited
+ * records or whitespace separated words, without going through
+ * iostreams. POSIX only.
+ */
+
+namespace useful {
+
+  namespace detail {
+    // Locale-independent isspace()
+    inline bool is_space(char c) noexcept {
+      return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    [[noreturn]] inline void throw_errno(const char *what) {
+      throw std::system_error(errno, std::generic_category(), what);
+    }
+  };
+
+  /* A read-only memory mapping of an entire file. Throws
+   * std::system_error if the file can't be opened or mapped. An empty
+   * file results in an empty mapping. */
+  class mapped_file {
+  private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+
+    void map(int fd) {
+      struct stat st;
+      if (fstat(fd, &st) < 0)
+        detail::throw_errno("fstat");
+      if (st.st_size == 0)
+        return;
+      void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED)
+        detail::throw_errno("mmap");
+      madvise(p, st.st_size, MADV_SEQUENTIAL);
+      data_ = static_cast<const char *>(p);
+      size_ = st.st_size;
+    }
+
+  public:
+    mapped_file() = default;
+
+    explicit mapped_file(const std::string &path) {
+      int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0)
+        detail::throw_errno(path.c_str());
+      try {
+        map(fd);
+      } catch (...) {
+        close(fd);
+        throw;
+      }
+      close(fd);
+    }
+
+    // Maps all of an already open file, whatever its current offset.
+    // Does not take ownership of fd.
+    explicit mapped_file(int fd) { map(fd); }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file& operator=(const mapped_file &) = delete;
+    mapped_file(mapped_file &&o) noexcept
+      : data_(std::exchange(o.data_, nullptr)), size_(std::exchange(o.size_, 0)) {}
+    mapped_file& operator=(mapped_file &&o) noexcept {
+      std::swap(data_, o.data_);
+      std::swap(size_, o.size_);
+      return *this;
+    }
+    ~mapped_file() {
+      if (data_)
+        munmap(const_cast<char *>(data_), size_);
+    }
+
+    const char *data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    std::string_view view() const noexcept { return {data_, size_}; }
+  };
+
+  /* Reads records from a file. Regular files are memory mapped;
+   * anything else (pipes, terminals, sockets) is read in large
+   * page-aligned blocks, with records that straddle a block boundary
+   * carried over into the next one.
+   *
+   * | record_reader in(0);
+   * | std::string_view word;
+   * | while (in.next_word(word)) { ... }
+   *
+   * For a mapped file the returned views stay valid for the lifetime
+   * of the reader. Otherwise they are only good until the next call
+   * to one of the next_ functions.
+   */
+  class record_reader {
+  public:
+    static constexpr std::size_t default_block_size = 1 << 20;
+
+  private:
+    struct free_deleter {
+      void operator()(char *p) const noexcept { std::free(p); }
+    };
+
+    mapped_file map;
+    int fd = -1;
+    bool owns_fd = false;
+    bool eof = true;
+    std::unique_ptr<char, free_deleter> buf;
+    std::size_t cap = 0;
+    const char *pos = nullptr, *end = nullptr;
+
+    void init(std::size_t block) {
+      struct stat st;
+      if (fstat(fd, &st) < 0)
+        detail::throw_errno("fstat");
+      if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        // Start where the file offset is, like read() would
+        off_t off = lseek(fd, 0, SEEK_CUR);
+        if (off < 0)
+          detail::throw_errno("lseek");
+        map = mapped_file(fd);
+        pos = map.data() + std::min<std::size_t>(off, map.size());
+        end = map.data() + map.size();
+        return;
+      }
+      posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+      cap = block > 0 ? block : default_block_size;
+      void *p;
+      if (posix_memalign(&p, 4096, cap) != 0)
+        throw std::bad_alloc();
+      buf.reset(static_cast<char *>(p));
+      pos = end = buf.get();
+      eof = false;
+    }
+
+    // Moves the unconsumed tail of the buffer to the front, growing it
+    // if the tail fills it, and reads more data after it.
+    void refill() {
+      std::size_t tail = end - pos;
+      if (tail == cap) {
+        void *p;
+        if (posix_memalign(&p, 4096, cap * 2) != 0)
+          throw std::bad_alloc();
+        std::memcpy(p, pos, tail);
+        buf.reset(static_cast<char *>(p));
+        cap *= 2;
+      } else if (pos != buf.get()) {
+        std::memmove(buf.get(), pos, tail);
+      }
+      pos = buf.get();
+      end = pos + tail;
+      while (true) {
+        ssize_t n = read(fd, buf.get() + tail, cap - tail);
+        if (n < 0) {
+          if (errno == EINTR)
+            continue;
+          detail::throw_errno("read");
+        }
+        if (n == 0)
+          eof = true;
+        end += n;
+        return;
+      }
+    }
+
+  public:
+    explicit record_reader(const std::string &path,
+                           std::size_t block = default_block_size) {
+      fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0)
+        detail::throw_errno(path.c_str());
+      owns_fd = true;
+      try {
+        init(block);
+      } catch (...) {
+        close(fd);
+        throw;
+      }
+    }
+
+    // Reads from an already open file, starting at its current offset.
+    // Does not take ownership of fd.
+    explicit record_reader(int fd_, std::size_t block = default_block_size)
+      : fd(fd_) {
+      init(block);
+    }
+
+    record_reader(const record_reader &) = delete;
+    record_reader& operator=(const record_reader &) = delete;
+    ~record_reader() {
+      if (owns_fd)
+        close(fd);
+    }
+
+    // True if the file is memory mapped instead of read in blocks.
+    bool mapped() const noexcept { return !map.empty(); }
+
+    // Reads the next record terminated by delim, not including the
+    // delimiter. The last record doesn't need a trailing delimiter.
+    bool next_record(std::string_view &rec, char delim) {
+      std::size_t scanned = 0;
+      while (true) {
+        auto p = static_cast<const char *>(std::memchr(pos + scanned, delim,
+                                                       end - pos - scanned));
+        if (p) {
+          rec = std::string_view(pos, p - pos);
+          pos = p + 1;
+          return true;
+        }
+        scanned = end - pos;
+        if (eof) {
+          if (pos == end)
+            return false;
+          rec = std::string_view(pos, end - pos);
+          pos = end;
+          return true;
+        }
+        refill();
+      }
+    }
+
+    bool next_line(std::string_view &line) { return next_record(line, '\n'); }
+
+    // Reads the next whitespace-separated word.
+    bool next_word(std::string_view &word) {
+      while (true) {
+        while (pos != end && detail::is_space(*pos))
+          ++pos;
+        if (pos != end)
+          break;
+        if (eof)
+          return false;
+        refill();
+      }
+      std::size_t scanned = 0;
+      while (true) {
+        const char *p = pos + scanned;
+        while (p != end && !detail::is_space(*p))
+          ++p;
+        if (p != end || eof) {
+          word = std::string_view(pos, p - pos);
+          pos = p;
+          return true;
+        }
+        scanned = end - pos;
+        refill();
+      }
+    }
+  };
+};
+
+#endif
@@ -29,6 +29,8 @@ SOFTWARE.
 #include <iterator>
 #include <utility>
 #include <functional>
+#include <memory>
+#include <vector>
 
 /* Additional sorting algorithms that work on iterator ranges. Of note
  * is that insertion and selection sort only need forward iterators,
@@ -100,6 +102,32 @@ namespace useful {
       std::inplace_merge(first, mlast, last, comp);
   }
 	
+  /* Bottom-up merge sort that merges through a buffer from alloc (like
+   * an arena_allocator) instead of letting std::inplace_merge get one
+   * from the heap for every merge. Stable. */
+  template<class BidirectionalIterator, class Compare, class Allocator>
+  void merge_sort(BidirectionalIterator first, BidirectionalIterator last, Compare comp,
+                  const Allocator &alloc) {
+    using value_type = typename std::iterator_traits<BidirectionalIterator>::value_type;
+    using buffer_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+    auto length = std::distance(first, last);
+    std::vector<value_type, buffer_alloc> buf{buffer_alloc(alloc)};
+    buf.reserve(length);
+    for (decltype(length) width = 1; width < length; width += width) {
+      auto lo = first;
+      for (decltype(length) start = 0; start + width < length; start += width + width) {
+        auto mid = std::next(lo, width);
+        auto hi = std::next(mid, std::min(width, length - start - width));
+        buf.clear();
+        std::merge(std::make_move_iterator(lo), std::make_move_iterator(mid),
+                   std::make_move_iterator(mid), std::make_move_iterator(hi),
+                   std::back_inserter(buf), comp);
+        std::move(buf.begin(), buf.end(), lo);
+        lo = hi;
+      }
+    }
+  }
+	
   template<class BidirectionalIterator>
   void merge_sort(BidirectionalIterator first, BidirectionalIterator last) {
     using value_type = typename std::iterator_traits<BidirectionalIterator>::value_type;
@@ -0,0 +1,305 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 shawnw
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef USEFUL_STATS_HPP
+#define USEFUL_STATS_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "useful/math.hpp"
+#include "useful/thread.hpp"
+
+namespace useful {
+
+  namespace detail {
+    // The histogram has 2^hist_sub_bits buckets per power of two, for
+    // magnitudes from 2^hist_min_exp up to 2^hist_max_exp, one set for
+    // each sign, plus a bucket for zero (and anything smaller). Larger
+    // magnitudes go in the outermost buckets.
+    constexpr int hist_sub_bits = 4;
+    constexpr int hist_min_exp = -64;
+    constexpr int hist_max_exp = 64;
+    constexpr std::size_t hist_half =
+      std::size_t(hist_max_exp - hist_min_exp) << hist_sub_bits;
+    constexpr std::size_t hist_buckets = 2 * hist_half + 1;
+
+    // Buckets are numbered in ascending order of value.
+    inline std::size_t hist_bucket(double x) noexcept {
+      std::uint64_t bits;
+      std::memcpy(&bits, &x, sizeof bits);
+      std::uint64_t mag = bits & ~(std::uint64_t(1) << 63);
+      int e = int(mag >> 52) - 1023;
+      if (e < hist_min_exp)
+        return hist_half;
+      std::size_t i = e >= hist_max_exp ? hist_half - 1
+        : std::size_t(e - hist_min_exp) << hist_sub_bits
+          | (mag >> (52 - hist_sub_bits) & ((1 << hist_sub_bits) - 1));
+      return bits >> 63 ? hist_half - 1 - i : hist_half + 1 + i;
+    }
+
+    // The value frac (0 to 1) of the way through a bucket's range
+    inline double hist_value(std::size_t b, double frac) noexcept {
+      if (b == hist_half)
+        return 0;
+      bool neg = b < hist_half;
+      std::size_t i = neg ? hist_half - 1 - b : b - hist_half - 1;
+      int e = int(i >> hist_sub_bits) + hist_min_exp;
+      double sub = (i & ((1 << hist_sub_bits) - 1)) + (neg ? 1 - frac : frac);
+      double v = std::ldexp(1 + sub / (1 << hist_sub_bits), e);
+      return neg ? -v : v;
+    }
+  };
+
+  /* Summary statistics of a stream of numbers, computed in one pass:
+   * count, sum, mean, variance (Welford's method), min, max, and
+   * approximate quantiles from a log-bucketed histogram (16 buckets per
+   * power of two, so quantiles are within about 6% of the true value,
+   * and usually much closer). Two accumulators can be merged, so each
+   * thread or shard can keep its own and combine them at the end.
+   *
+   * Adding a contiguous range works a block at a time: the sum and
+   * min/max of each block are vectorisable loops, its variance comes
+   * from a second pass while it's still in cache, and the block is then
+   * merged in like another accumulator. NaNs aren't handled specially.
+   *
+   * The histogram is a fixed 32KB per accumulator.
+   */
+  template<class T = double>
+  class stats {
+    static_assert(std::is_arithmetic<T>::value, "stats needs a numeric type");
+  public:
+    using value_type = T;
+    // Sums of floating point values are kept as at least double, and of
+    // integers as 64 bits of the same signedness.
+    using sum_type = typename std::conditional<std::is_floating_point<T>::value,
+                                               typename std::common_type<T, double>::type,
+                                               typename std::conditional<std::is_signed<T>::value,
+                                                                         std::int64_t, std::uint64_t>::type>::type;
+
+  private:
+    static constexpr std::size_t block = 1024;
+
+    std::uint64_t n = 0;
+    sum_type total = 0;
+    double mean_ = 0;
+    double m2 = 0;
+    T lo = std::numeric_limits<T>::max();
+    T hi = std::numeric_limits<T>::lowest();
+    std::vector<std::uint64_t> hist;
+
+    // Chan et al.'s formula for combining the moments of two sets
+    void merge_moments(std::uint64_t bn, double bmean, double bm2) noexcept {
+      if (bn == 0)
+        return;
+      std::uint64_t total_n = n + bn;
+      double delta = bmean - mean_;
+      mean_ += delta * bn / total_n;
+      m2 += bm2 + delta * delta * (double(n) * bn / total_n);
+      n = total_n;
+    }
+
+    // Floating point blocks use sum()'s kernels; integers are summed
+    // in the wider sum_type so they can't overflow T.
+    static sum_type block_sum(const T *p, std::size_t m, std::true_type) {
+      return detail::reduce_fast<T, false>(p, m);
+    }
+    static sum_type block_sum(const T *p, std::size_t m, std::false_type) {
+      sum_type bsum = 0;
+      for (std::size_t i = 0; i < m; i += 1)
+        bsum += p[i];
+      return bsum;
+    }
+
+    void add_block(const T *p, std::size_t m) {
+      sum_type bsum = block_sum(p, m, std::integral_constant<bool, std::is_same<T, float>::value
+                                                            || std::is_same<T, double>::value>());
+      T blo = lo, bhi = hi;
+      for (std::size_t i = 0; i < m; i += 1) {
+        blo = std::min(blo, p[i]);
+        bhi = std::max(bhi, p[i]);
+      }
+      double bmean = double(bsum) / m;
+      double d[4] = {0, 0, 0, 0};
+      std::size_t i = 0;
+      for (; i + 4 <= m; i += 4)
+        for (int j = 0; j < 4; j += 1) {
+          double x = double(p[i + j]) - bmean;
+          d[j] += x * x;
+        }
+      for (; i < m; i += 1) {
+        double x = double(p[i]) - bmean;
+        d[0] += x * x;
+      }
+      for (i = 0; i < m; i += 1)
+        hist[detail::hist_bucket(double(p[i]))] += 1;
+      total += bsum;
+      lo = blo;
+      hi = bhi;
+      merge_moments(m, bmean, (d[0] + d[1]) + (d[2] + d[3]));
+    }
+
+    // Contiguous values of type T, added a block at a time
+    template<class InputIterator>
+    void add_range(InputIterator b, InputIterator e, std::true_type) {
+      if (b == e)
+        return;
+      const T *p = &*b;
+      std::size_t m = e - b;
+      for (std::size_t i = 0; i < m; i += block)
+        add_block(p + i, std::min(std::size_t(block), m - i));
+    }
+
+    template<class InputIterator>
+    void add_range(InputIterator b, InputIterator e, std::false_type) {
+      for (; b != e; ++b)
+        add(*b);
+    }
+
+  public:
+    stats() : hist(detail::hist_buckets) {}
+
+    /* Adds one value */
+    void add(T x) {
+      n += 1;
+      total += x;
+      double delta = double(x) - mean_;
+      mean_ += delta / n;
+      m2 += delta * (double(x) - mean_);
+      lo = std::min(lo, x);
+      hi = std::max(hi, x);
+      hist[detail::hist_bucket(double(x))] += 1;
+    }
+
+    /* Adds every value in a range. Pointers and vector iterators to T
+     * are processed a block at a time; anything else convertible to T
+     * is added one value at a time. */
+    template<class InputIterator>
+    void add(InputIterator b, InputIterator e) {
+      add_range(b, e, std::integral_constant<bool,
+                (std::is_pointer<InputIterator>::value
+                 || detail::is_vector_iterator<InputIterator>::value)
+                && std::is_same<typename std::iterator_traits<InputIterator>::value_type, T>::value>());
+    }
+
+    /* Combines another accumulator into this one */
+    void merge(const stats &other) {
+      total += other.total;
+      lo = std::min(lo, other.lo);
+      hi = std::max(hi, other.hi);
+      for (std::size_t i = 0; i < hist.size(); i += 1)
+        hist[i] += other.hist[i];
+      merge_moments(other.n, other.mean_, other.m2);
+    }
+
+    void clear() noexcept {
+      n = 0;
+      total = 0;
+      mean_ = m2 = 0;
+      lo = std::numeric_limits<T>::max();
+      hi = std::numeric_limits<T>::lowest();
+      std::fill(hist.begin(), hist.end(), 0);
+    }
+
+    std::uint64_t count() const noexcept { return n; }
+    sum_type sum() const noexcept { return total; }
+    // 0 when empty
+    double mean() const noexcept { return mean_; }
+    // The population variance; 0 with fewer than two values
+    double variance() const noexcept { return n > 1 ? m2 / n : 0; }
+    // The sample (n - 1) variance; 0 with fewer than two values
+    double sample_variance() const noexcept { return n > 1 ? m2 / (n - 1) : 0; }
+    double stddev() const noexcept { return std::sqrt(variance()); }
+    // The largest and smallest values of T when empty
+    T min() const noexcept { return lo; }
+    T max() const noexcept { return hi; }
+
+    /* Returns an approximation of the q-quantile, 0 <= q <= 1. The 0 and
+     * 1 quantiles are the exact min and max. Throws std::domain_error if
+     * no values have been added. */
+    double quantile(double q) const {
+      if (n == 0)
+        throw std::domain_error("quantile of no values");
+      if (q <= 0)
+        return lo;
+      if (q >= 1)
+        return hi;
+      std::uint64_t rank = std::llround(q * (n - 1));
+      std::uint64_t seen = 0;
+      std::size_t b = 0;
+      for (; b + 1 < hist.size(); b += 1) {
+        seen += hist[b];
+        if (seen > rank)
+          break;
+      }
+      // Interpolate, assuming the values in the bucket are evenly spread
+      double frac = (rank - (seen - hist[b]) + 0.5) / hist[b];
+      return std::min<double>(std::max<double>(detail::hist_value(b, frac), lo), hi);
+    }
+
+    double median() const { return quantile(0.5); }
+  };
+
+  /* Returns the stats of every value in a container. */
+  template<class Container>
+  stats<typename Container::value_type> summarize(const Container &c) {
+    stats<typename Container::value_type> s;
+    s.add(std::begin(c), std::end(c));
+    return s;
+  }
+
+  /* Returns the stats of every value in a random access container,
+   * split into a contiguous slice per thread (default_threads() if
+   * threads is 0) that are merged in order. The count, sum of integers,
+   * min, max and histogram don't depend on the thread count; the mean
+   * and variance can differ in the last bits. */
+  template<class Container>
+  stats<typename Container::value_type> parallel_summarize(const Container &c, unsigned threads = 0) {
+    using S = stats<typename Container::value_type>;
+    std::size_t total = std::end(c) - std::begin(c);
+    if (threads == 0)
+      threads = default_threads();
+    threads = std::max<std::size_t>(1, std::min<std::size_t>(threads, total / 4096));
+    std::vector<S> parts(threads);
+    run_threads(threads, [&](unsigned t) {
+        std::size_t first = total / threads * t + std::min<std::size_t>(t, total % threads);
+        std::size_t count = total / threads + (t < total % threads);
+        auto b = std::begin(c) + first;
+        parts[t].add(b, b + count);
+      });
+    for (unsigned t = 1; t < threads; t += 1)
+      parts[0].merge(parts[t]);
+    return std::move(parts[0]);
+  }
+};
+
+#endif
@@ -27,9 +27,122 @@ SOFTWARE.
 
 #include <string>
 #include <regex>
+#include <vector>
+#include <list>
+#include <array>
+#include <memory>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "useful/mutex.hpp"
 
 namespace useful {
 
+  /* A bounded, thread-safe LRU cache of compiled regular expressions,
+   * keyed by pattern string and syntax flags. The cache is split into
+   * shards, each with its own lock and LRU list, so threads looking up
+   * different patterns rarely contend. Compilation happens outside of
+   * any lock. Regexes are handed out as shared_ptrs, so evicting one
+   * never invalidates a copy that's still in use.
+   *
+   * hits() and misses() can be used to size the cache for a workload.
+   */
+  class regex_cache {
+  public:
+    using flag_type = std::regex::flag_type;
+    using pointer = std::shared_ptr<const std::regex>;
+    static constexpr std::size_t shards = 8;
+
+  private:
+    using key_type = std::pair<std::string, flag_type>;
+    struct key_hash {
+      std::size_t operator()(const key_type &k) const {
+        return std::hash<std::string>()(k.first)
+          ^ (static_cast<std::size_t>(k.second) * 0x9e3779b9U);
+      }
+    };
+    using lru_list = std::list<std::pair<key_type, pointer>>;
+    struct shard {
+      mutable spin_lock lock;
+      lru_list lru; // Most recently used at the front
+      std::unordered_map<key_type, lru_list::iterator, key_hash> index;
+    };
+
+    std::array<shard, shards> table;
+    std::size_t per_shard;
+    std::atomic<unsigned long> nhits{0}, nmisses{0};
+
+  public:
+    explicit regex_cache(std::size_t capacity = 64)
+      : per_shard(capacity > shards ? (capacity + shards - 1) / shards : 1) {}
+    regex_cache(const regex_cache &) = delete;
+    regex_cache& operator=(const regex_cache &) = delete;
+
+    // Returns the compiled form of pattern, compiling and caching it if needed.
+    // Throws std::regex_error on a bad pattern, which is not cached.
+    pointer get(const std::string &pattern, flag_type flags = std::regex::ECMAScript) {
+      key_type key{pattern, flags};
+      shard &sh = table[key_hash()(key) % shards];
+      {
+        std::lock_guard<spin_lock> guard{sh.lock};
+        auto i = sh.index.find(key);
+        if (i != sh.index.end()) {
+          sh.lru.splice(sh.lru.begin(), sh.lru, i->second);
+          nhits.fetch_add(1, std::memory_order_relaxed);
+          return i->second->second;
+        }
+      }
+      nmisses.fetch_add(1, std::memory_order_relaxed);
+      auto re = std::make_shared<const std::regex>(pattern, flags);
+      std::lock_guard<spin_lock> guard{sh.lock};
+      // Another thread might have added it while we were compiling.
+      auto i = sh.index.find(key);
+      if (i != sh.index.end()) {
+        sh.lru.splice(sh.lru.begin(), sh.lru, i->second);
+        return i->second->second;
+      }
+      sh.lru.emplace_front(key, re);
+      sh.index.emplace(std::move(key), sh.lru.begin());
+      if (sh.lru.size() > per_shard) {
+        sh.index.erase(sh.lru.back().first);
+        sh.lru.pop_back();
+      }
+      return re;
+    }
+
+    unsigned long hits() const { return nhits.load(std::memory_order_relaxed); }
+    unsigned long misses() const { return nmisses.load(std::memory_order_relaxed); }
+    std::size_t capacity() const { return per_shard * shards; }
+
+    std::size_t size() const {
+      std::size_t n = 0;
+      for (const auto &sh : table) {
+        std::lock_guard<spin_lock> guard{sh.lock};
+        n += sh.lru.size();
+      }
+      return n;
+    }
+
+    // Empties the cache and resets the hit and miss counters.
+    void clear() {
+      for (auto &sh : table) {
+        std::lock_guard<spin_lock> guard{sh.lock};
+        sh.index.clear();
+        sh.lru.clear();
+      }
+      nhits = 0;
+      nmisses = 0;
+    }
+  };
+
+  /* The cache used by the split functions that take a pattern string. */
+  inline regex_cache &default_regex_cache() {
+    static regex_cache cache;
+    return cache;
+  }
+
   // perl style split on regular expression functions.
   template<class OutputIterator>
   int split(const std::string &s, const std::regex &re, OutputIterator o) {
@@ -45,7 +158,7 @@ namespace useful {
 
   template<class OutputIterator, class T>
   int split(const std::string &s, const T &re, OutputIterator o) {
-    return split(s, std::regex(re), o);
+    return split(s, *default_regex_cache().get(re), o);
   }
 
   template<class OutputIterator>
@@ -54,15 +167,40 @@ namespace useful {
     return split(s, whitespace, o);
   }
 
+  namespace detail {
+#ifndef USEFUL_DETAIL_MAKE_VOID
+#define USEFUL_DETAIL_MAKE_VOID
+    template<class... T>
+    struct make_void { using type = void; };
+#endif
+
+    template<class T, class = void>
+    struct is_allocator : std::false_type {};
+    template<class T>
+    struct is_allocator<T, typename make_void<typename T::value_type,
+                                              decltype(std::declval<T &>().allocate(std::size_t(1)))>::type>
+      : std::true_type {};
+  };
+
+  /* What the allocator-aware overloads of splitv() and tokenize() return:
+   * a vector of strings where the vector and every string use (rebound
+   * copies of) the given allocator, like an arena_allocator. */
+  template<class Allocator>
+  using alloc_string = std::basic_string<char, std::char_traits<char>,
+    typename std::allocator_traits<Allocator>::template rebind_alloc<char>>;
+  template<class Allocator>
+  using alloc_string_vector = std::vector<alloc_string<Allocator>,
+    typename std::allocator_traits<Allocator>::template rebind_alloc<alloc_string<Allocator>>>;
+
   inline std::vector<std::string> splitv(const std::string &s, const std::regex &re) {
     std::regex_token_iterator<std::string::const_iterator> rend{},
       ri{s.begin(), s.end(), re, -1};
       return std::vector<std::string>(ri, rend);
   }
 
-  template<class T>
+  template<class T, typename = typename std::enable_if<!detail::is_allocator<T>::value>::type>
   std::vector<std::string> splitv(const std::string &s, const T &re) {
-    return splitv(s, std::regex(re));
+    return splitv(s, *default_regex_cache().get(re));
   }
 
   inline std::vector<std::string> splitv(const std::string &s) {
@@ -70,6 +208,27 @@ namespace useful {
     return splitv(s, whitespace);
   }
 
+  template<class Allocator>
+  alloc_string_vector<Allocator> splitv(const std::string &s, const std::regex &re, const Allocator &a) {
+    std::regex_token_iterator<std::string::const_iterator> rend{},
+      ri{s.begin(), s.end(), re, -1};
+    alloc_string_vector<Allocator> res(a);
+    for (; ri != rend; ++ri)
+      res.emplace_back(ri->first, ri->second, a);
+    return res;
+  }
+
+  template<class T, class Allocator>
+  alloc_string_vector<Allocator> splitv(const std::string &s, const T &re, const Allocator &a) {
+    return splitv(s, *default_regex_cache().get(re), a);
+  }
+
+  template<class Allocator, typename = typename std::enable_if<detail::is_allocator<Allocator>::value>::type>
+  alloc_string_vector<Allocator> splitv(const std::string &s, const Allocator &a) {
+    const static std::regex whitespace{"\\s+"};
+    return splitv(s, whitespace, a);
+  }
+
   /* And a strtok style tokenizing function */
   inline std::vector<std::string> tokenize(const std::string &s, const std::string &tokens) {
     std::string::size_type start{0}, end;
@@ -81,6 +240,18 @@ namespace useful {
     res.push_back(std::move(s.substr(start)));
     return res;
   }
+
+  template<class Allocator>
+  alloc_string_vector<Allocator> tokenize(const std::string &s, const std::string &tokens, const Allocator &a) {
+    std::string::size_type start{0}, end;
+    alloc_string_vector<Allocator> res(a);
+    while ((end = s.find_first_of(tokens, start)) != std::string::npos) {
+      res.emplace_back(s.data() + start, end - start, a);
+      start = end + 1;
+    }
+    res.emplace_back(s.data() + start, s.size() - start, a);
+    return res;
+  }
 };
 
 #endif
@@ -0,0 +1,304 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 shawnw
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef USEFUL_STRING_POOL_HPP
+#define USEFUL_STRING_POOL_HPP
+
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+#include <utility>
+#include <mutex>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace useful {
+
+  /* String interning. Each distinct string added to a pool is copied
+   * once into large contiguous arena blocks, and identified by a small
+   * integer handle. Views of interned strings stay valid for the
+   * lifetime of the pool. Lookups go through an open addressing hash
+   * table with linear probing.
+   *
+   * | string_pool pool;
+   * | auto h = pool.intern("the");   // Same handle for every "the"
+   * | std::string_view the = pool[h];
+   *
+   * string_pool isn't thread safe; use one per thread (see
+   * local_string_pool()) or a concurrent_string_pool.
+   */
+  class string_pool {
+  public:
+    using handle = std::uint32_t;
+    static constexpr handle npos = ~handle(0);
+    static constexpr std::size_t default_block_size = 64 * 1024;
+
+  private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char *next = nullptr;
+    std::size_t left = 0;
+    std::size_t block_size;
+    std::size_t nbytes = 0;
+    std::vector<std::string_view> strings;
+    std::vector<std::size_t> hashes;
+    std::vector<handle> slots; // npos marks an empty slot
+    std::size_t mask = 0;
+
+    static std::size_t hash(std::string_view s) {
+      return std::hash<std::string_view>()(s);
+    }
+
+    // Copies s into the arena. Big strings get a block of their own.
+    const char *store(std::string_view s) {
+      if (s.empty())
+        return "";
+      if (s.size() > left) {
+        if (s.size() > block_size / 4) {
+          blocks.emplace_back(new char[s.size()]);
+          nbytes += s.size();
+          std::memcpy(blocks.back().get(), s.data(), s.size());
+          return blocks.back().get();
+        }
+        blocks.emplace_back(new char[block_size]);
+        nbytes += block_size;
+        next = blocks.back().get();
+        left = block_size;
+      }
+      char *p = next;
+      std::memcpy(p, s.data(), s.size());
+      next += s.size();
+      left -= s.size();
+      return p;
+    }
+
+    // Returns the slot holding s, or the empty slot where it belongs.
+    std::size_t probe(std::string_view s, std::size_t h) const {
+      std::size_t i = h & mask;
+      while (slots[i] != npos
+             && (hashes[slots[i]] != h || strings[slots[i]] != s))
+        i = (i + 1) & mask;
+      return i;
+    }
+
+    void rehash(std::size_t nslots) {
+      slots.assign(nslots, npos);
+      mask = nslots - 1;
+      for (handle n = 0; n < strings.size(); n += 1) {
+        std::size_t i = hashes[n] & mask;
+        while (slots[i] != npos)
+          i = (i + 1) & mask;
+        slots[i] = n;
+      }
+    }
+
+    // Empties the pool without allocating. The slot table is made again
+    // by the next intern().
+    void reset() noexcept {
+      blocks.clear();
+      next = nullptr;
+      left = 0;
+      nbytes = 0;
+      strings.clear();
+      hashes.clear();
+      slots.clear();
+      mask = 0;
+    }
+
+  public:
+    explicit string_pool(std::size_t block = default_block_size)
+      : block_size(block > 0 ? block : default_block_size) {
+      rehash(16);
+    }
+    string_pool(const string_pool &) = delete;
+    string_pool& operator=(const string_pool &) = delete;
+    // A moved-from pool is left empty, as if just constructed.
+    string_pool(string_pool &&o) noexcept
+      : blocks(std::move(o.blocks)), next(o.next), left(o.left), block_size(o.block_size),
+        nbytes(o.nbytes), strings(std::move(o.strings)), hashes(std::move(o.hashes)),
+        slots(std::move(o.slots)), mask(o.mask) {
+      o.reset();
+    }
+
+    string_pool& operator=(string_pool &&o) noexcept {
+      if (this != &o) {
+        blocks = std::move(o.blocks);
+        next = o.next;
+        left = o.left;
+        block_size = o.block_size;
+        nbytes = o.nbytes;
+        strings = std::move(o.strings);
+        hashes = std::move(o.hashes);
+        slots = std::move(o.slots);
+        mask = o.mask;
+        o.reset();
+      }
+      return *this;
+    }
+
+    // Returns the handle of s, adding it to the pool if needed.
+    handle intern(std::string_view s) {
+      if (slots.empty())
+        rehash(16);
+      std::size_t h = hash(s);
+      std::size_t i = probe(s, h);
+      if (slots[i] != npos)
+        return slots[i];
+      if (strings.size() >= npos)
+        throw std::length_error{"string_pool is full"};
+      handle n = strings.size();
+      strings.emplace_back(store(s), s.size());
+      hashes.push_back(h);
+      // Keep the load factor under 1/2
+      if (strings.size() * 2 > slots.size())
+        rehash(slots.size() * 2);
+      else
+        slots[i] = n;
+      return n;
+    }
+
+    // Like intern(), but returns a view of the pooled copy of s.
+    std::string_view intern_view(std::string_view s) { return strings[intern(s)]; }
+
+    // Returns the handle of s, or npos if it isn't in the pool.
+    handle find(std::string_view s) const {
+      return slots.empty() ? npos : slots[probe(s, hash(s))];
+    }
+
+    std::string_view operator[](handle h) const { return strings[h]; }
+
+    // The number of distinct strings in the pool.
+    std::size_t size() const noexcept { return strings.size(); }
+    // The number of bytes allocated for string data.
+    std::size_t bytes() const noexcept { return nbytes; }
+
+    void reserve(std::size_t n) {
+      strings.reserve(n);
+      hashes.reserve(n);
+      std::size_t nslots = std::max<std::size_t>(slots.size(), 16);
+      while (nslots < n * 2)
+        nslots *= 2;
+      if (nslots != slots.size())
+        rehash(nslots);
+    }
+
+    // Removes all strings. Invalidates all handles and views.
+    void clear() {
+      reset();
+      rehash(16);
+    }
+  };
+
+  /* A string_pool for the calling thread. */
+  inline string_pool &local_string_pool() {
+    thread_local string_pool pool;
+    return pool;
+  }
+
+  /* A thread-safe string pool. Strings are spread over a number of
+   * independently locked string_pools by hash, so threads interning
+   * different strings usually don't contend. The shard number is kept
+   * in the low bits of each handle. */
+  class concurrent_string_pool {
+  public:
+    using handle = string_pool::handle;
+    static constexpr handle npos = string_pool::npos;
+
+  private:
+    // Handles are pool handles shifted left by shard_bits, so a shard
+    // can hold 2^28 - 1 strings (one fewer than fits, so no handle is
+    // npos). intern() and find() throw std::length_error past that.
+    static constexpr unsigned shard_bits = 4;
+    static constexpr std::size_t shards = 1 << shard_bits;
+    struct shard {
+      mutable std::mutex lock;
+      string_pool pool;
+    };
+    std::array<shard, shards> table;
+
+    static std::size_t which(std::string_view s) {
+      // The top bits, since the pools use the bottom ones
+      return std::hash<std::string_view>()(s) >> (sizeof(std::size_t) * 8 - shard_bits);
+    }
+
+    static handle make_handle(handle h, std::size_t n) {
+      if (h >= npos >> shard_bits)
+        throw std::length_error{"concurrent_string_pool shard is full"};
+      return (h << shard_bits) | n;
+    }
+
+  public:
+    concurrent_string_pool() = default;
+    concurrent_string_pool(const concurrent_string_pool &) = delete;
+    concurrent_string_pool& operator=(const concurrent_string_pool &) = delete;
+
+    handle intern(std::string_view s) {
+      std::size_t n = which(s);
+      std::lock_guard<std::mutex> guard{table[n].lock};
+      return make_handle(table[n].pool.intern(s), n);
+    }
+
+    std::string_view intern_view(std::string_view s) {
+      std::size_t n = which(s);
+      std::lock_guard<std::mutex> guard{table[n].lock};
+      return table[n].pool.intern_view(s);
+    }
+
+    handle find(std::string_view s) const {
+      std::size_t n = which(s);
+      std::lock_guard<std::mutex> guard{table[n].lock};
+      handle h = table[n].pool.find(s);
+      return h == npos ? npos : make_handle(h, n);
+    }
+
+    std::string_view operator[](handle h) const {
+      const shard &sh = table[h & (shards - 1)];
+      std::lock_guard<std::mutex> guard{sh.lock};
+      return sh.pool[h >> shard_bits];
+    }
+
+    std::size_t size() const {
+      std::size_t n = 0;
+      for (const auto &sh : table) {
+        std::lock_guard<std::mutex> guard{sh.lock};
+        n += sh.pool.size();
+      }
+      return n;
+    }
+
+    std::size_t bytes() const {
+      std::size_t n = 0;
+      for (const auto &sh : table) {
+        std::lock_guard<std::mutex> guard{sh.lock};
+        n += sh.pool.bytes();
+      }
+      return n;
+    }
+  };
+};
+
+#endif
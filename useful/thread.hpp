@@ -0,0 +1,76 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 shawnw
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef USEFUL_THREAD_HPP
+#define USEFUL_THREAD_HPP
+
+#include <thread>
+#include <vector>
+#include <exception>
+
+namespace useful {
+
+  /* The number of threads to use when the caller doesn't specify
+   * one: the hardware concurrency, or 1 if that isn't known. */
+  inline unsigned default_threads() noexcept {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+  }
+
+  /* Runs fn(0) through fn(n - 1) concurrently, fn(0) on the calling
+   * thread, and waits for all of them to finish. If any of them throw,
+   * the exception from the lowest numbered one is rethrown once they're
+   * all done. */
+  template<class Function>
+  void run_threads(unsigned n, Function fn) {
+    if (n == 0)
+      return;
+    std::vector<std::exception_ptr> errors(n);
+    auto run = [&](unsigned i) {
+      try {
+        fn(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(n - 1);
+    try {
+      for (unsigned i = 1; i < n; i += 1)
+        threads.emplace_back(run, i);
+    } catch (...) {
+      for (auto &t : threads)
+        t.join();
+      throw;
+    }
+    run(0);
+    for (auto &t : threads)
+      t.join();
+    for (auto &e : errors)
+      if (e)
+        std::rethrow_exception(e);
+  }
+};
+
+#endif
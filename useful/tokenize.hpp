@@ -0,0 +1,129 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 shawnw
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef USEFUL_TOKENIZE_HPP
+#define USEFUL_TOKENIZE_HPP
+
+#include <string_view>
+#include <vector>
+
+#include "useful/thread.hpp"
+
+/* Allocation-free tokenizing of string_views on a set of delimiter
+ * characters, on one thread or several.
+ */
+
+namespace useful {
+
+  namespace detail {
+    // Lookup table for a set of delimiter characters
+    class char_set {
+    private:
+      bool in[256] = {};
+    public:
+      explicit char_set(std::string_view chars) {
+        for (unsigned char c : chars)
+          in[c] = true;
+      }
+      bool operator()(char c) const { return in[static_cast<unsigned char>(c)]; }
+    };
+  };
+
+  /* Calls f on each token of s separated by any of the characters in
+   * delims. Like strtok(), runs of delimiters count as one and empty
+   * tokens are skipped. Nothing is copied; the tokens are views into s. */
+  template<class Function>
+  void for_each_token(std::string_view s, std::string_view delims, Function f) {
+    detail::char_set isdelim(delims);
+    const char *p = s.data(), *end = p + s.size();
+    while (true) {
+      while (p != end && isdelim(*p))
+        ++p;
+      if (p == end)
+        return;
+      const char *start = p;
+      while (p != end && !isdelim(*p))
+        ++p;
+      f(std::string_view(start, p - start));
+    }
+  }
+
+  /* Splits s into n roughly equal chunks, moving each boundary forward
+   * to just past a delimiter so no token is split between two chunks.
+   * Some chunks can be empty. */
+  inline std::vector<std::string_view>
+  token_chunks(std::string_view s, std::string_view delims, unsigned n) {
+    detail::char_set isdelim(delims);
+    std::vector<std::string_view> chunks;
+    chunks.reserve(n);
+    std::size_t start = 0;
+    for (unsigned i = 1; i <= n; i += 1) {
+      std::size_t end = i == n ? s.size() : s.size() / n * i;
+      if (end < start)
+        end = start;
+      while (end > 0 && end < s.size() && !isdelim(s[end - 1]))
+        ++end;
+      chunks.push_back(s.substr(start, end - start));
+      start = end;
+    }
+    return chunks;
+  }
+
+  /* Tokenizes s like for_each_token(), splitting it into chunks that are
+   * tokenized on separate threads (default_threads() if threads is 0).
+   * Calls f(chunk, token) for each token; f is called concurrently for
+   * different chunks, and in order within a chunk, so per-chunk results
+   * can be kept in a vector indexed by chunk number and merged later. */
+  template<class Function>
+  void parallel_for_each_token(std::string_view s, std::string_view delims,
+                               Function f, unsigned threads = 0) {
+    if (threads == 0)
+      threads = default_threads();
+    auto chunks = token_chunks(s, delims, threads);
+    run_threads(threads, [&](unsigned i) {
+        for_each_token(chunks[i], delims, [&](std::string_view tok) { f(i, tok); });
+      });
+  }
+
+  /* Tokenizes s in parallel, returning all tokens in their original order. */
+  inline std::vector<std::string_view>
+  parallel_tokenize(std::string_view s, std::string_view delims, unsigned threads = 0) {
+    if (threads == 0)
+      threads = default_threads();
+    std::vector<std::vector<std::string_view>> parts(threads);
+    parallel_for_each_token(s, delims,
+                            [&](unsigned i, std::string_view tok) { parts[i].push_back(tok); },
+                            threads);
+    std::size_t total = 0;
+    for (const auto &p : parts)
+      total += p.size();
+    std::vector<std::string_view> res;
+    res.reserve(total);
+    for (const auto &p : parts)
+      res.insert(res.end(), p.begin(), p.end());
+    return res;
+  }
+};
+
+#endif